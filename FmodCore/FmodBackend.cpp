@@ -0,0 +1,370 @@
+#include "FmodBackend.hpp"
+#include <fmod_errors.h>
+#include <algorithm>
+#include <array>
+#include <limits>
+
+// Count the FMOD calls of the frame, the expression keeps the value of the call.
+#define CountFmod(func) (++m_CallCount, func)
+// Bits of the decoded PCM of a stream when FMOD doesn't give the ones of its format.
+#define STREAM_DECODE_BITS 16
+
+namespace Voxymore::Audio
+{
+    // FMOD gives no user data to the memory callbacks, the allocator of the setup is kept here.
+    static MemorySetup s_FmodAllocator;
+    // FMOD::Memory_Initialize can only be called once per process, before the first FMOD object: the setup given to the first
+    // backend (and the block allocated for its fmodMemoryPoolSize) is kept by every following one.
+    static bool s_FmodMemoryInitialized = false;
+    static MemorySetup s_FmodRequestedMemory;
+    static uint32_t s_FmodRequestedPoolSize = 0;
+    static MemorySetup s_FmodMemory;
+    static std::unique_ptr<std::byte[]> s_FmodMemoryPool;
+
+    static bool IsSameMemorySetup(const MemorySetup& a, const MemorySetup& b)
+    {
+        return a.block == b.block && a.blockSize == b.blockSize && a.alloc == b.alloc && a.realloc == b.realloc && a.free == b.free && a.user == b.user;
+    }
+
+    static void* F_CALL FmodAlloc(unsigned int size, FMOD_MEMORY_TYPE /*type*/, const char* /*source*/)
+    {
+        return s_FmodAllocator.alloc(size, s_FmodAllocator.user);
+    }
+
+    static void* F_CALL FmodRealloc(void* ptr, unsigned int size, FMOD_MEMORY_TYPE /*type*/, const char* /*source*/)
+    {
+        return s_FmodAllocator.realloc(ptr, size, s_FmodAllocator.user);
+    }
+
+    static void F_CALL FmodFree(void* ptr, FMOD_MEMORY_TYPE /*type*/, const char* /*source*/)
+    {
+        s_FmodAllocator.free(ptr, s_FmodAllocator.user);
+    }
+
+    // Indexed by SpeakerMode.
+    static const std::array<FMOD_SPEAKERMODE, 9> s_FmodSpeakerModes = {
+        FMOD_SPEAKERMODE_DEFAULT,
+        FMOD_SPEAKERMODE_RAW,
+        FMOD_SPEAKERMODE_MONO,
+        FMOD_SPEAKERMODE_STEREO,
+        FMOD_SPEAKERMODE_QUAD,
+        FMOD_SPEAKERMODE_SURROUND,
+        FMOD_SPEAKERMODE_5POINT1,
+        FMOD_SPEAKERMODE_7POINT1,
+        FMOD_SPEAKERMODE_7POINT1POINT4,
+    };
+
+    FmodBackend::FmodBackend(const EngineConfig& config, const MemorySetup& memory)
+    {
+        InitializeMemory(config, memory);
+        CheckFmod(FMOD::System_Create(&m_System));
+        if(config.useAsyncFileSystem)
+        {
+            m_FileSystem = std::make_unique<FmodFileSystem>(static_cast<uint32_t>(std::max(config.ioThreads, 1)));
+            CheckFmod(m_FileSystem->Install(m_System));
+        }
+        ConfigureOutput(config);
+        // Without real time there is no reason for FMOD's stream thread, the update decodes them so the runs are reproducible.
+        FMOD_INITFLAGS initFlags = config.IsNonRealTime() ? FMOD_INIT_STREAM_FROM_UPDATE : FMOD_INIT_NORMAL;
+        void* driverData = config.outputMode == OutputMode::WavWriterNrt ? const_cast<char*>(config.wavWriterPath.c_str()) : nullptr;
+        CheckFmod(m_System->init(config.numberOfChannels, initFlags, driverData));
+        CheckFmod(m_System->getSoftwareFormat(&m_SampleRate, nullptr, nullptr));
+        unsigned int dspBufferLength = 0;
+        int dspBufferCount = 0;
+        CheckFmod(m_System->getDSPBufferSize(&dspBufferLength, &dspBufferCount));
+        // Nothing is buffered for a device without real time.
+        if(!config.IsNonRealTime()) m_OutputLatencyMs = 1000.0f * static_cast<float>(dspBufferLength) * static_cast<float>(dspBufferCount) / static_cast<float>(m_SampleRate);
+        CheckFmod(m_System->getMasterChannelGroup(&m_MasterGroup));
+
+        // The buffers every stream allocates, to count them in the sample memory budget.
+        CheckFmod(m_System->getStreamBufferSize(&m_StreamFileBufferSize, &m_StreamFileBufferUnit));
+        FMOD_ADVANCEDSETTINGS settings = {};
+        settings.cbSize = sizeof(FMOD_ADVANCEDSETTINGS);
+        CheckFmod(m_System->getAdvancedSettings(&settings));
+        m_StreamDecodeBufferMs = settings.defaultDecodeBufferSize;
+    }
+
+    FmodBackend::~FmodBackend()
+    {
+        CheckFmod(m_System->release());
+    }
+
+    void FmodBackend::ConfigureOutput(const EngineConfig& config)
+    {
+        switch (config.outputMode)
+        {
+            case OutputMode::RealTime:
+                break;
+            case OutputMode::NoSoundNrt:
+                CheckFmod(m_System->setOutput(FMOD_OUTPUTTYPE_NOSOUND_NRT));
+                break;
+            case OutputMode::WavWriterNrt:
+                CheckFmod(m_System->setOutput(FMOD_OUTPUTTYPE_WAVWRITER_NRT));
+                break;
+        }
+
+        if(config.dspBufferLength > 0 || config.dspBufferCount > 0)
+        {
+            unsigned int length = 0;
+            int count = 0;
+            CheckFmod(m_System->getDSPBufferSize(&length, &count));
+            if(config.dspBufferLength > 0) length = config.dspBufferLength;
+            if(config.dspBufferCount > 0) count = config.dspBufferCount;
+            CheckFmod(m_System->setDSPBufferSize(length, count));
+        }
+
+        if(config.sampleRate > 0 || config.speakerMode != SpeakerMode::Default)
+        {
+            int sampleRate = 0;
+            FMOD_SPEAKERMODE speakerMode = FMOD_SPEAKERMODE_DEFAULT;
+            int rawSpeakers = 0;
+            CheckFmod(m_System->getSoftwareFormat(&sampleRate, &speakerMode, &rawSpeakers));
+            if(config.sampleRate > 0) sampleRate = config.sampleRate;
+            if(config.speakerMode != SpeakerMode::Default) speakerMode = s_FmodSpeakerModes[static_cast<size_t>(config.speakerMode)];
+            CheckFmod(m_System->setSoftwareFormat(sampleRate, speakerMode, rawSpeakers));
+        }
+
+        if(config.softwareChannels > 0) CheckFmod(m_System->setSoftwareChannels(config.softwareChannels));
+
+        // FMOD keeps its default for the 0 values.
+        FMOD_ADVANCEDSETTINGS settings = {};
+        settings.cbSize = sizeof(FMOD_ADVANCEDSETTINGS);
+        settings.maxMPEGCodecs = config.maxMpegCodecs;
+        settings.maxADPCMCodecs = config.maxAdpcmCodecs;
+        settings.maxXMACodecs = config.maxXmaCodecs;
+        settings.maxVorbisCodecs = config.maxVorbisCodecs;
+        settings.maxAT9Codecs = config.maxAt9Codecs;
+        settings.maxFADPCMCodecs = config.maxFadpcmCodecs;
+        settings.maxOpusCodecs = config.maxOpusCodecs;
+        CheckFmod(m_System->setAdvancedSettings(&settings));
+    }
+
+    void FmodBackend::InitializeMemory(const EngineConfig& config, const MemorySetup& memory)
+    {
+        // The pool size only matters when the setup gives no memory.
+        uint32_t poolSize = !memory.block && !memory.alloc ? config.fmodMemoryPoolSize : 0u;
+        if(s_FmodMemoryInitialized)
+        {
+            if(!IsSameMemorySetup(memory, s_FmodRequestedMemory) || poolSize != s_FmodRequestedPoolSize)
+            {
+                std::cerr << "Voxaudio ERROR : FMOD can only set up its memory once per process, the memory setup of the first Init is kept." << std::endl;
+            }
+            m_Memory = s_FmodMemory;
+            return;
+        }
+        s_FmodMemoryInitialized = true;
+        s_FmodRequestedMemory = memory;
+        s_FmodRequestedPoolSize = poolSize;
+
+        m_Memory = memory;
+        if(poolSize > 0)
+        {
+            m_Memory.blockSize = poolSize & ~511u;
+            s_FmodMemoryPool = std::make_unique<std::byte[]>(m_Memory.blockSize);
+            m_Memory.block = s_FmodMemoryPool.get();
+        }
+
+        if(m_Memory.block)
+        {
+            m_Memory.blockSize &= ~511u;
+            CheckFmod(FMOD::Memory_Initialize(m_Memory.block, static_cast<int>(m_Memory.blockSize), nullptr, nullptr, nullptr, FMOD_MEMORY_ALL));
+        }
+        else if(m_Memory.alloc && m_Memory.realloc && m_Memory.free)
+        {
+            s_FmodAllocator = m_Memory;
+            CheckFmod(FMOD::Memory_Initialize(nullptr, 0, &FmodAlloc, &FmodRealloc, &FmodFree, FMOD_MEMORY_ALL));
+        }
+        s_FmodMemory = m_Memory;
+    }
+
+    uint64_t FmodBackend::GetDspClock() const
+    {
+        unsigned long long dspClock = 0;
+        CheckFmod(m_MasterGroup->getDSPClock(&dspClock, nullptr));
+        return dspClock;
+    }
+
+    void FmodBackend::Update()
+    {
+        CountFmod(m_System->update());
+    }
+
+    void FmodBackend::SetListener(const Vector3& position, const Vector3* velocity, const Vector3& look, const Vector3& up)
+    {
+        auto fmodPos = FmodHelper::VectorToFmod(position);
+        auto fmodLook = FmodHelper::VectorToFmod(look);
+        auto fmodUp = FmodHelper::VectorToFmod(up);
+        auto fmodVel = velocity ? FmodHelper::VectorToFmod(*velocity) : FMOD_VECTOR{};
+        //TODO: Add a multi-listener system.
+        CheckFmod(CountFmod(m_System->set3DListenerAttributes(0, &fmodPos, velocity ? &fmodVel : nullptr, &fmodLook, &fmodUp)));
+    }
+
+    uint32_t FmodBackend::ConsumeCallCount()
+    {
+        uint32_t count = m_CallCount;
+        m_CallCount = 0;
+        return count;
+    }
+
+    MemoryStats FmodBackend::GetMemoryStats()
+    {
+        // FMOD keeps its own high-water mark, whatever the allocator.
+        int fmodCurrent = 0;
+        int fmodPeak = 0;
+        CheckFmod(CountFmod(FMOD::Memory_GetStats(&fmodCurrent, &fmodPeak, false)));
+        return {static_cast<uint64_t>(fmodCurrent), static_cast<uint64_t>(fmodPeak), m_Memory.block ? m_Memory.blockSize : 0u};
+    }
+
+    IoStats FmodBackend::ConsumeIoStats()
+    {
+        if(!m_FileSystem) return {};
+        return m_FileSystem->ConsumeStats();
+    }
+
+    FmodBackend::SoundHandle FmodBackend::CreateSound(const SoundDefinition& definition, LoadPriority priority, std::span<const std::byte> packEntry, bool blocking)
+    {
+        // FMOD_NONBLOCKING = load sound async.
+        FMOD_MODE mode = blocking ? FMOD_DEFAULT : FMOD_NONBLOCKING;
+        mode |= definition.is3D ? (FMOD_3D | FMOD_3D_INVERSETAPEREDROLLOFF) : FMOD_2D;
+        mode |= definition.isLooping ? FMOD_LOOP_NORMAL : FMOD_LOOP_OFF;
+        mode |= definition.isStream ? FMOD_CREATESTREAM : FMOD_CREATECOMPRESSEDSAMPLE;
+
+        FMOD::Sound* sound = nullptr;
+        FMOD_RESULT result;
+        FMOD_CREATESOUNDEXINFO info{};
+        info.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+        if(!packEntry.empty())
+        {
+            // FMOD reads the mapped pack in place, the data is never copied.
+            info.length = static_cast<unsigned int>(packEntry.size());
+            result = CountFmod(m_System->createSound(reinterpret_cast<const char*>(packEntry.data()), mode | FMOD_OPENMEMORY_POINT, &info, &sound));
+        }
+        else
+        {
+            if(m_FileSystem) info.fileuserdata = m_FileSystem->FileUserData(definition, priority);
+            result = CountFmod(m_System->createSound(definition.name.c_str(), mode, &info, &sound));
+        }
+        CheckFmod(result);
+        return result == FMOD_OK ? sound : nullptr;
+    }
+
+    BackendLoadState FmodBackend::GetLoadState(SoundHandle sound)
+    {
+        FMOD_OPENSTATE openState = FMOD_OPENSTATE_ERROR;
+        CheckFmod(CountFmod(sound->getOpenState(&openState, nullptr, nullptr, nullptr)));
+        if(openState == FMOD_OPENSTATE_LOADING || openState == FMOD_OPENSTATE_CONNECTING || openState == FMOD_OPENSTATE_BUFFERING) return BackendLoadState::Loading;
+        return openState == FMOD_OPENSTATE_ERROR ? BackendLoadState::Error : BackendLoadState::Ready;
+    }
+
+    uint64_t FmodBackend::FinishLoad(SoundHandle sound, const SoundDefinition& definition)
+    {
+        // The distances can't be set before the sound is ready.
+        CheckFmod(CountFmod(sound->set3DMinMaxDistance(definition.minDistance, definition.maxDistance)));
+
+        if(definition.isStream) return GetStreamResidentBytes(sound);
+        // Compressed samples stay in memory as they are in the file.
+        unsigned int rawBytes = 0;
+        CheckFmod(CountFmod(sound->getLength(&rawBytes, FMOD_TIMEUNIT_RAWBYTES)));
+        return rawBytes;
+    }
+
+    uint64_t FmodBackend::GetStreamResidentBytes(SoundHandle sound)
+    {
+        // The file buffer, converted to bytes with the ratio of the stream when its size isn't given in bytes.
+        uint64_t fileBytes = m_StreamFileBufferSize;
+        if(m_StreamFileBufferUnit != FMOD_TIMEUNIT_RAWBYTES)
+        {
+            unsigned int rawBytes = 0;
+            unsigned int length = 0;
+            CheckFmod(CountFmod(sound->getLength(&rawBytes, FMOD_TIMEUNIT_RAWBYTES)));
+            CheckFmod(CountFmod(sound->getLength(&length, m_StreamFileBufferUnit)));
+            fileBytes = length > 0 ? fileBytes * rawBytes / length : 0;
+        }
+
+        // The decode buffer, CreateSound leaves its size to the default of the advanced settings.
+        int channels = 0;
+        int bits = 0;
+        float frequency = 0.0f;
+        CheckFmod(CountFmod(sound->getFormat(nullptr, nullptr, &channels, &bits)));
+        CheckFmod(CountFmod(sound->getDefaults(&frequency, nullptr)));
+        auto decodeFrames = static_cast<uint64_t>(frequency * static_cast<float>(m_StreamDecodeBufferMs) / 1000.0f);
+        return fileBytes + decodeFrames * static_cast<uint64_t>(channels) * static_cast<uint64_t>(bits > 0 ? bits : STREAM_DECODE_BITS) / 8;
+    }
+
+    void FmodBackend::ReleaseSound(SoundHandle sound)
+    {
+        CheckFmod(CountFmod(sound->release()));
+    }
+
+    FmodBackend::VoiceHandle FmodBackend::StartVoice(SoundHandle sound, uint64_t startClock)
+    {
+        FMOD::Channel* channel = nullptr;
+        CountFmod(m_System->playSound(sound, nullptr, true, &channel));
+        if(!channel) return nullptr;
+
+        // FMOD holds the channel until the clock of its parent (the master group) reaches the start.
+        if(startClock > 0) CountFmod(channel->setDelay(startClock, 0, false));
+        return channel;
+    }
+
+    void FmodBackend::StopVoice(VoiceHandle voice)
+    {
+        CountFmod(voice->stop());
+    }
+
+    bool FmodBackend::IsVoicePlaying(VoiceHandle voice)
+    {
+        bool isPlaying = false;
+        CountFmod(voice->isPlaying(&isPlaying));
+        return isPlaying;
+    }
+
+    void FmodBackend::SetVoicePosition(VoiceHandle voice, const Vector3& position)
+    {
+        FMOD_VECTOR p = FmodHelper::VectorToFmod(position);
+        CountFmod(voice->set3DAttributes(&p, nullptr));
+    }
+
+    void FmodBackend::SetVoiceVolume(VoiceHandle voice, float gain)
+    {
+        // FMOD ramps the volume change itself.
+        CountFmod(voice->setVolume(gain));
+    }
+
+    void FmodBackend::SetVoicePaused(VoiceHandle voice, bool paused)
+    {
+        CountFmod(voice->setPaused(paused));
+    }
+
+    void FmodBackend::SetVoiceFadePoints(VoiceHandle voice, std::span<const FadePoint> points)
+    {
+        CountFmod(voice->removeFadePoints(0, std::numeric_limits<unsigned long long>::max()));
+        for (const FadePoint& point : points)
+        {
+            CountFmod(voice->addFadePoint(point.Clock, point.Gain));
+        }
+    }
+
+    FMOD_VECTOR FmodHelper::VectorToFmod(const Vector3& v)
+    {
+        FMOD_VECTOR fv;
+        fv.x = v.x;
+        fv.y = v.y;
+        fv.z = v.z;
+        return fv;
+    }
+
+    Vector3 FmodHelper::FmodToVector(const FMOD_VECTOR& fv)
+    {
+        Vector3 v;
+        v.x = fv.x;
+        v.y = fv.y;
+        v.z = fv.z;
+        return v;
+    }
+
+    std::string FmodHelper::GetFmodError(FMOD_RESULT result)
+    {
+        return FMOD_ErrorString(result);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include "EngineConfig.hpp"
+#include "BackendTypes.hpp"
+#include "FmodFileSystem.hpp"
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <fmod.hpp>
+
+#define FmodResult Combine(result , __LINE__)
+#define CheckFmod(func) {FMOD_RESULT FmodResult = func; if(FmodResult != FMOD_RESULT::FMOD_OK) {std::cerr << "FMOD ERROR : " << ::Voxymore::Audio::FmodHelper::GetFmodError(FmodResult) << std::endl; VXM_BREAK;} }
+
+namespace Voxymore::Audio
+{
+    // The FMOD Core backend, see AudioBackendType for what each function does.
+    class FmodBackend
+    {
+    public:
+        typedef FMOD::Sound* SoundHandle;
+        typedef FMOD::Channel* VoiceHandle;
+        static constexpr const char* ConfigSection = "Voxaudio.FmodCore";
+
+        FmodBackend(const EngineConfig& config, const MemorySetup& memory);
+        ~FmodBackend();
+        FmodBackend(const FmodBackend&) = delete;
+        FmodBackend& operator=(const FmodBackend&) = delete;
+
+        int GetSampleRate() const { return m_SampleRate; }
+        float GetOutputLatencyMs() const { return m_OutputLatencyMs; }
+        // The FMOD API is thread safe, the call isn't counted as the frame stats belong to the engine thread.
+        uint64_t GetDspClock() const;
+
+        void Update();
+        void SetListener(const Vector3& position, const Vector3* velocity, const Vector3& look, const Vector3& up);
+        uint32_t ConsumeCallCount();
+        MemoryStats GetMemoryStats();
+        IoStats ConsumeIoStats();
+
+        SoundHandle CreateSound(const SoundDefinition& definition, LoadPriority priority, std::span<const std::byte> packEntry, bool blocking);
+        BackendLoadState GetLoadState(SoundHandle sound);
+        uint64_t FinishLoad(SoundHandle sound, const SoundDefinition& definition);
+        void ReleaseSound(SoundHandle sound);
+
+        VoiceHandle StartVoice(SoundHandle sound, uint64_t startClock);
+        void StopVoice(VoiceHandle voice);
+        bool IsVoicePlaying(VoiceHandle voice);
+        void SetVoicePosition(VoiceHandle voice, const Vector3& position);
+        void SetVoiceVolume(VoiceHandle voice, float gain);
+        void SetVoicePaused(VoiceHandle voice, bool paused);
+        void SetVoiceFadePoints(VoiceHandle voice, std::span<const FadePoint> points);
+    private:
+        // Give the output type, format and codec pools of the config to FMOD, before its initialization.
+        void ConfigureOutput(const EngineConfig& config);
+        // Route the FMOD allocations to the block or the allocator of the setup, must be called before the system is created.
+        // Only the first call of the process gives the setup to FMOD, the next ones keep it and reject a different setup.
+        void InitializeMemory(const EngineConfig& config, const MemorySetup& memory);
+        // FMOD doesn't report the memory of a sound, a stream holds its file buffer and its decode buffer.
+        uint64_t GetStreamResidentBytes(SoundHandle sound);
+    private:
+        FMOD::System* m_System = nullptr;
+        FMOD::ChannelGroup* m_MasterGroup = nullptr;
+        int m_SampleRate = 48000;
+        // Audio queued between the mixer and the device, from the buffer size FMOD really uses.
+        float m_OutputLatencyMs = 0.0f;
+        uint32_t m_CallCount = 0;
+        // Stream buffer sizes of the FMOD system, the decode buffer is in milliseconds.
+        unsigned int m_StreamFileBufferSize = 0;
+        FMOD_TIMEUNIT m_StreamFileBufferUnit = FMOD_TIMEUNIT_RAWBYTES;
+        unsigned int m_StreamDecodeBufferMs = 0;
+        // The memory FMOD really uses, the one of the first backend of the process.
+        MemorySetup m_Memory;
+        // Null when the FMOD file system is used, released after the FMOD system which closes its files.
+        std::unique_ptr<FmodFileSystem> m_FileSystem;
+    };
+
+    namespace FmodHelper
+    {
+        FMOD_VECTOR VectorToFmod(const Vector3& v);
+        Vector3 FmodToVector(const FMOD_VECTOR& fv);
+        std::string GetFmodError(FMOD_RESULT result);
+    }
+}
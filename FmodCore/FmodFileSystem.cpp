@@ -0,0 +1,100 @@
+#include "FmodFileSystem.hpp"
+#include <limits>
+
+// FMOD asks its stream reads with this priority, and 0 for the rest.
+#define FMOD_STREAM_READ_PRIORITY 100
+
+namespace Voxymore::Audio
+{
+    FmodFileSystem::FmodFileSystem(uint32_t threadCount) : m_Scheduler(threadCount)
+    {
+        for (size_t i = 0; i < m_Contexts.size(); ++i)
+        {
+            m_Contexts[i] = {this, static_cast<IoPriority>(i)};
+        }
+    }
+
+    FMOD_RESULT FmodFileSystem::Install(FMOD::System* system)
+    {
+        // The synchronous read and seek are not given, FMOD only uses the asynchronous ones.
+        return system->setFileSystem(&FmodFileSystem::Open, &FmodFileSystem::Close, nullptr, nullptr, &FmodFileSystem::AsyncRead, &FmodFileSystem::AsyncCancel, BlockAlign);
+    }
+
+    void* FmodFileSystem::FileUserData(const SoundDefinition& definition, LoadPriority priority)
+    {
+        IoPriority ioPriority = IoPriority::Prefetch;
+        if(definition.isStream) ioPriority = IoPriority::Stream;
+        else if(priority == LoadPriority::Imminent) ioPriority = IoPriority::Imminent;
+        return &m_Contexts[static_cast<size_t>(ioPriority)];
+    }
+
+    FMOD_RESULT F_CALL FmodFileSystem::Open(const char* name, unsigned int* fileSize, void** handle, void* userData)
+    {
+        if(!userData) return FMOD_ERR_INVALID_PARAM;
+
+        auto* file = new IoFile();
+        if(!file->Open(name))
+        {
+            delete file;
+            return FMOD_ERR_FILE_NOTFOUND;
+        }
+        if(file->Size() > std::numeric_limits<unsigned int>::max())
+        {
+            delete file;
+            return FMOD_ERR_FILE_BAD;
+        }
+
+        *fileSize = static_cast<unsigned int>(file->Size());
+        *handle = file;
+        return FMOD_OK;
+    }
+
+    FMOD_RESULT F_CALL FmodFileSystem::Close(void* handle, void* /*userData*/)
+    {
+        delete static_cast<IoFile*>(handle);
+        return FMOD_OK;
+    }
+
+    FMOD_RESULT F_CALL FmodFileSystem::AsyncRead(FMOD_ASYNCREADINFO* info, void* userData)
+    {
+        auto* context = static_cast<Context*>(userData);
+
+        IoScheduler::Request request;
+        request.File = static_cast<const IoFile*>(info->handle);
+        request.Offset = info->offset;
+        request.Buffer = info->buffer;
+        request.Size = info->sizebytes;
+        request.Priority = info->priority >= FMOD_STREAM_READ_PRIORITY ? IoPriority::Stream : context->Priority;
+        request.Done = &FmodFileSystem::ReadDone;
+        request.User = info;
+        context->FileSystem->m_Scheduler.Submit(request);
+        return FMOD_OK;
+    }
+
+    FMOD_RESULT F_CALL FmodFileSystem::AsyncCancel(FMOD_ASYNCREADINFO* info, void* userData)
+    {
+        auto* context = static_cast<Context*>(userData);
+
+        // A read already started is finished (and FMOD told) before Cancel returns, a queued one is told here.
+        if(context->FileSystem->m_Scheduler.Cancel(info))
+        {
+            info->done(info, FMOD_ERR_FILE_DISKEJECTED);
+            return FMOD_ERR_FILE_DISKEJECTED;
+        }
+        return FMOD_OK;
+    }
+
+    void FmodFileSystem::ReadDone(void* user, int64_t bytesRead)
+    {
+        auto* info = static_cast<FMOD_ASYNCREADINFO*>(user);
+        if(bytesRead < 0)
+        {
+            info->bytesread = 0;
+            info->done(info, FMOD_ERR_FILE_BAD);
+            return;
+        }
+
+        info->bytesread = static_cast<unsigned int>(bytesRead);
+        info->done(info, info->bytesread < info->sizebytes ? FMOD_ERR_FILE_EOF : FMOD_OK);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include "IoScheduler.hpp"
+#include <array>
+#include <fmod.hpp>
+
+namespace Voxymore::Audio
+{
+    // Serve the file reads of FMOD with the I/O scheduler, so the reads of the streams never wait behind the sound loads.
+    // FMOD gives no context to the system callbacks, each file sound is created with the user data of a priority class
+    // (FileUserData) which the callbacks get back.
+    class FmodFileSystem
+    {
+    public:
+        // FMOD reads by blocks of this size, a multiple of the sector size of the usual disks.
+        static constexpr int BlockAlign = 2048;
+
+        explicit FmodFileSystem(uint32_t threadCount);
+
+        // Install the callbacks, before the system is initialized.
+        FMOD_RESULT Install(FMOD::System* system);
+
+        // The value of FMOD_CREATESOUNDEXINFO::fileuserdata for a sound of this definition.
+        void* FileUserData(const SoundDefinition& definition, LoadPriority priority);
+
+        // The counters since the previous call.
+        IoStats ConsumeStats() { return m_Scheduler.ConsumeStats(); }
+    private:
+        struct Context
+        {
+            FmodFileSystem* FileSystem;
+            IoPriority Priority;
+        };
+
+        static FMOD_RESULT F_CALL Open(const char* name, unsigned int* fileSize, void** handle, void* userData);
+        static FMOD_RESULT F_CALL Close(void* handle, void* userData);
+        static FMOD_RESULT F_CALL AsyncRead(FMOD_ASYNCREADINFO* info, void* userData);
+        static FMOD_RESULT F_CALL AsyncCancel(FMOD_ASYNCREADINFO* info, void* userData);
+        static void ReadDone(void* user, int64_t bytesRead);
+    private:
+        IoScheduler m_Scheduler;
+        std::array<Context, static_cast<size_t>(IoPriority::Count)> m_Contexts;
+    };
+}
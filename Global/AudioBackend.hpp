@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include "EngineConfig.hpp"
+#include "BackendTypes.hpp"
+#include "IoScheduler.hpp"
+#include <concepts>
+#include <cstddef>
+#include <span>
+
+// The backend is chosen when CMake is configured (VXM_BACKEND_*), the engine holds it by value and calls it directly:
+// there is no virtual call between the channel passes and the backend.
+#if defined(VXM_BACKEND_STUB)
+    #include "StubBackend.hpp"
+#elif defined(VXM_BACKEND_SOFTWARE)
+    #include "SoftwareBackend.hpp"
+#elif defined(VXM_BACKEND_MINIAUDIO)
+    #include "MiniaudioBackend.hpp"
+#elif defined(VXM_BACKEND_FMOD_CORE)
+    #include "FmodBackend.hpp"
+#else
+    #error "No audio backend selected, see the USE_*_BACKEND options of the CMakeLists."
+#endif
+
+namespace Voxymore::Audio
+{
+    // What the engine needs from a backend. The sound and voice handles are pointer like, a value initialized handle is none.
+    // Every function is called by the engine thread, except GetDspClock which must be thread safe.
+    template<typename T>
+    concept AudioBackendType = std::constructible_from<T, const EngineConfig&, const MemorySetup&>
+            && requires(T backend, const T constBackend, typename T::SoundHandle sound, typename T::VoiceHandle voice,
+                        const SoundDefinition& definition, std::span<const std::byte> packEntry, const Vector3& v, std::span<const FadePoint> points)
+    {
+        // Section of the config file read by the engine.
+        { T::ConfigSection } -> std::convertible_to<const char*>;
+        { constBackend.GetSampleRate() } -> std::same_as<int>;
+        { constBackend.GetOutputLatencyMs() } -> std::same_as<float>;
+        // Samples mixed since the backend started, the clock of the scheduled starts and of the fade points.
+        { constBackend.GetDspClock() } -> std::same_as<uint64_t>;
+        // Once per tick, after the channel parameters are pushed.
+        backend.Update();
+        backend.SetListener(v, &v, v, v);
+        // The backend calls since the previous one, for EngineStats::backendCalls.
+        { backend.ConsumeCallCount() } -> std::same_as<uint32_t>;
+        { backend.GetMemoryStats() } -> std::same_as<MemoryStats>;
+        { backend.ConsumeIoStats() } -> std::same_as<IoStats>;
+
+        // The data of a pack entry stays mapped until the backend is destroyed. Blocking loads are ready when this returns.
+        { backend.CreateSound(definition, LoadPriority::Imminent, packEntry, true) } -> std::same_as<typename T::SoundHandle>;
+        { backend.GetLoadState(sound) } -> std::same_as<BackendLoadState>;
+        // Called once the sound is ready, return the memory its data keeps.
+        { backend.FinishLoad(sound, definition) } -> std::same_as<uint64_t>;
+        backend.ReleaseSound(sound);
+
+        // The voice is created paused, it starts when the mixer clock reaches startClock once unpaused (at once if it is past).
+        { backend.StartVoice(sound, uint64_t{}) } -> std::same_as<typename T::VoiceHandle>;
+        // The voice is released, the handle must not be used anymore.
+        backend.StopVoice(voice);
+        // True until the end of the sound, paused or waiting for its start clock included.
+        { backend.IsVoicePlaying(voice) } -> std::same_as<bool>;
+        backend.SetVoicePosition(voice, v);
+        backend.SetVoiceVolume(voice, 1.0f);
+        backend.SetVoicePaused(voice, false);
+        // Replace the envelope of the voice, it multiplies its volume.
+        backend.SetVoiceFadePoints(voice, points);
+    };
+
+#if defined(VXM_BACKEND_STUB)
+    using AudioBackend = StubBackend;
+#elif defined(VXM_BACKEND_SOFTWARE)
+    using AudioBackend = SoftwareBackend;
+#elif defined(VXM_BACKEND_MINIAUDIO)
+    using AudioBackend = MiniaudioBackend;
+#elif defined(VXM_BACKEND_FMOD_CORE)
+    using AudioBackend = FmodBackend;
+#endif
+
+    static_assert(AudioBackendType<AudioBackend>, "The selected backend doesn't provide what the engine needs.");
+}
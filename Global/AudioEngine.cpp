@@ -0,0 +1,1315 @@
+//
+// Created by ianpo on 04/11/2023.
+//
+
+#include "AudioEngine.hpp"
+#include "FileDialogs.hpp"
+#include "SimdKernels.hpp"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <filesystem>
+#include <fstream>
+#include <yaml-cpp/yaml.h>
+
+#define VIRTUALIZE_FADE_TIME 1.0f
+#define SILENCE_dB -80.0f
+// Bonus given to the channels already real so two channels of similar audibility don't swap every frame.
+#define REAL_VOICE_HYSTERESIS_dB 3.0f
+// Fade points given to the backend for a fade, it ramps linearly between them.
+#define FADE_POINT_COUNT 16
+
+// Hint that the cache line of the address will be read soon, nothing on the compilers that don't have one.
+#if defined(__GNUC__) || defined(__clang__)
+    #define VXM_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <xmmintrin.h>
+    #define VXM_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+    #define VXM_PREFETCH(address)
+#endif
+
+namespace fs = std::filesystem;
+
+namespace Voxymore::Audio
+{
+    // Names of the speaker modes in the config file.
+    static const std::array<std::pair<SpeakerMode, const char*>, 9> s_SpeakerModeNames = {{
+        {SpeakerMode::Default, "Default"},
+        {SpeakerMode::Raw, "Raw"},
+        {SpeakerMode::Mono, "Mono"},
+        {SpeakerMode::Stereo, "Stereo"},
+        {SpeakerMode::Quad, "Quad"},
+        {SpeakerMode::Surround, "Surround"},
+        {SpeakerMode::FivePointOne, "5.1"},
+        {SpeakerMode::SevenPointOne, "7.1"},
+        {SpeakerMode::SevenPointOnePointFour, "7.1.4"},
+    }};
+
+    static const std::array<const char*, 3> s_OutputModeNames = {"RealTime", "NoSoundNrt", "WavWriterNrt"};
+
+    static OutputMode OutputModeFromName(const std::string& name)
+    {
+        for (size_t i = 0; i < s_OutputModeNames.size(); ++i)
+        {
+            if(name == s_OutputModeNames[i]) return static_cast<OutputMode>(i);
+        }
+        std::cerr << "Voxaudio ERROR : unknown output mode " << name << ", RealTime is used." << std::endl;
+        return OutputMode::RealTime;
+    }
+
+    static SpeakerMode SpeakerModeFromName(const std::string& name)
+    {
+        for (const auto& [mode, modeName] : s_SpeakerModeNames)
+        {
+            if(name == modeName) return mode;
+        }
+        std::cerr << "Voxaudio ERROR : unknown speaker mode " << name << ", the default one is used." << std::endl;
+        return SpeakerMode::Default;
+    }
+
+    static const char* SpeakerModeName(SpeakerMode speakerMode)
+    {
+        for (const auto& [mode, modeName] : s_SpeakerModeNames)
+        {
+            if(speakerMode == mode) return modeName;
+        }
+        return "Default";
+    }
+
+    AudioEngine::AudioEngine(const fs::path& configPath, const MemorySetup& memory)
+    {
+        ConfigPath = configPath;
+        if(configPath.empty())
+        {
+            ConfigPath = FileDialogs::OpenFile({"Voxaudio Config (*.vxm)", "*.vxm"});
+
+            if(configPath.empty())
+            {
+                ConfigPath = "./VoxaudioConfig.vxm";
+            }
+        }
+
+        if(fs::exists(ConfigPath)) ReadConfigFile();
+        else WriteConfigFile();
+
+        m_DormantGrid.SetCellSize(Config.spatialCellSize);
+        Sounds.SetCapacity(static_cast<uint32_t>(std::max(Config.maxSounds, 1)));
+        Channels.SetCapacity(static_cast<uint32_t>(std::max(Config.maxChannels, 1)));
+
+        ReserveFrameBuffers();
+
+        m_PlayingChannelsCapacity = Channels.GetCapacity();
+        m_PlayingChannels = std::make_unique<std::atomic<TypeId>[]>(m_PlayingChannelsCapacity);
+        for (uint32_t i = 0; i < m_PlayingChannelsCapacity; ++i)
+        {
+            m_PlayingChannels[i].store(NullId, std::memory_order_relaxed);
+        }
+
+        m_Commands.Reserve(static_cast<size_t>(std::max(Config.commandQueueCapacity, 2)));
+        m_SoundDefinitions.SetCapacity(static_cast<uint32_t>(std::max(Config.soundDefinitionPoolCapacity, 0)));
+        m_ChannelBatches.SetCapacity(static_cast<uint32_t>(std::max(Config.channelBatchPoolCapacity, 0)));
+
+        for (const std::string& packPath : Config.soundPacks)
+        {
+            auto pack = std::make_unique<SoundPack>();
+            if(pack->Open(packPath)) m_SoundPacks.push_back(std::move(pack));
+            else std::cerr << "Voxaudio ERROR : can't mount the sound pack " << packPath << std::endl;
+        }
+
+        m_Backend.emplace(Config, memory);
+        m_SampleRate = m_Backend->GetSampleRate();
+        m_DspClock = m_Backend->GetDspClock();
+
+        if(Config.useEngineThread)
+        {
+            m_ThreadRunning = true;
+            m_Thread = std::thread(&AudioEngine::ThreadMain, this);
+        }
+    }
+
+    AudioEngine::~AudioEngine()
+    {
+        if(m_Thread.joinable())
+        {
+            m_ThreadRunning = false;
+            m_Thread.join();
+        }
+
+        // Commands that were never executed still own their sound definition.
+        m_Commands.Drain([this](EngineCommand& command)
+        {
+            m_SoundDefinitions.Delete(command.Definition);
+            delete command.Batch;
+            m_ChannelBatches.Delete(command.Channels);
+            delete command.Pack;
+        });
+
+        m_Backend.reset();
+    }
+
+    void AudioEngine::Update([[maybe_unused]] float deltaTime)
+    {
+        // The engine times its fades with the mixer clock of the backend, the frame time isn't needed.
+        if(Config.useEngineThread) return;
+        Tick();
+    }
+
+    void AudioEngine::ReserveFrameBuffers()
+    {
+        // Every list is bounded by the capacity of the tables, reserving it once keeps the update from allocating.
+        size_t channelCapacity = Channels.GetCapacity();
+        m_DormantGrid.SetCapacity(Channels.GetCapacity());
+        for (auto& bucket : m_StateBuckets)
+        {
+            bucket.reserve(channelCapacity);
+        }
+        m_StoppedChannels.reserve(channelCapacity);
+        m_VirtualMask.reserve(channelCapacity);
+        m_VoiceCandidates.reserve(channelCapacity);
+        m_Audibilities.reserve(channelCapacity);
+        m_RolloffGains.reserve(channelCapacity);
+        m_DirtyVolumeChannels.reserve(channelCapacity);
+        m_DirtyVolumesdB.reserve(channelCapacity);
+        m_ChannelGains.reserve(channelCapacity);
+        m_MovedDormantChannels.reserve(channelCapacity);
+        // A moved channel may also be found by the query.
+        m_WakingChannels.reserve(channelCapacity * 2);
+        m_SleepingChannels.reserve(channelCapacity);
+        m_LoadingSounds.reserve(Sounds.GetCapacity());
+    }
+
+    void AudioEngine::PublishMemoryStats()
+    {
+        auto category = [this](MemoryCategory category) -> MemoryStats& { return m_PendingStats.memory[static_cast<size_t>(category)]; };
+
+        category(MemoryCategory::Backend) = m_Backend->GetMemoryStats();
+
+        category(MemoryCategory::Sounds) = {Sounds.Size(), m_SoundsPeak, Sounds.GetCapacity()};
+        category(MemoryCategory::Channels) = {Channels.Size(), m_ChannelsPeak, Channels.GetCapacity()};
+        category(MemoryCategory::SoundDefinitions) = {m_SoundDefinitions.Used(), m_SoundDefinitions.Peak(), m_SoundDefinitions.GetCapacity()};
+        m_PendingStats.soundDefinitionPoolOverflows = m_SoundDefinitions.Overflows();
+        category(MemoryCategory::ChannelBatches) = {m_ChannelBatches.Used(), m_ChannelBatches.Peak(), m_ChannelBatches.GetCapacity()};
+        m_PendingStats.channelBatchPoolOverflows = m_ChannelBatches.Overflows();
+    }
+
+    void AudioEngine::ThreadMain()
+    {
+        using Clock = std::chrono::steady_clock;
+        const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(Config.engineTickRate, 1.0f)));
+
+        auto next = Clock::now() + period;
+        while (m_ThreadRunning)
+        {
+            Tick();
+
+            std::this_thread::sleep_until(next);
+            next += period;
+            // Don't try to catch up after a hitch, the next tick simply sees more mixed time.
+            if(next < Clock::now()) next = Clock::now() + period;
+        }
+    }
+
+    bool AudioEngine::IsPlaying(TypeId channelId) const
+    {
+        uint32_t slot = SlotHandle::Index(channelId);
+        if(channelId == NullId || slot >= m_PlayingChannelsCapacity) return false;
+        return m_PlayingChannels[slot].load(std::memory_order_acquire) == channelId;
+    }
+
+    EngineStats AudioEngine::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        return m_LastFrameStats;
+    }
+
+    template<typename Prefetch, typename Write>
+    void AudioEngine::ForEachBatchChannel(const ChannelBatch& batch, Prefetch&& prefetch, Write&& write)
+    {
+        if(batch.Count == 0) return;
+
+        uint32_t next = Channels.Find(batch.Ids[0]);
+        for (uint32_t i = 0; i < batch.Count; ++i)
+        {
+            uint32_t channel = next;
+            if(i + 1 < batch.Count)
+            {
+                next = Channels.Find(batch.Ids[i + 1]);
+                if(next != SlotTable::InvalidIndex) prefetch(next);
+            }
+            if(channel != SlotTable::InvalidIndex) write(channel, i);
+        }
+    }
+
+    void AudioEngine::ExecuteCommand(EngineCommand& command)
+    {
+        switch (command.Type)
+        {
+            case CommandType::RegisterSound:
+            {
+                Sounds.Insert(command.Id, *command.Definition);
+                m_SoundDefinitions.Delete(command.Definition);
+                command.Definition = nullptr;
+                if(command.Flags & EngineCommand::Load) LoadSound(command.Id, command.Priority);
+                break;
+            }
+            case CommandType::RegisterSounds:
+            {
+                SoundRegistrationBatch& batch = *command.Batch;
+                for (size_t i = 0; i < batch.Ids.size(); ++i)
+                {
+                    Sounds.Insert(batch.Ids[i], std::move(batch.Definitions[i]));
+                    if(command.Flags & EngineCommand::Load) LoadSound(batch.Ids[i], command.Priority);
+                }
+                delete command.Batch;
+                command.Batch = nullptr;
+                break;
+            }
+            case CommandType::MountSoundPack:
+                m_SoundPacks.emplace_back(command.Pack);
+                command.Pack = nullptr;
+                break;
+            case CommandType::UnregisterSound:
+            {
+                // The one shot sounds are shared, only the cache destroys them.
+                const Sound* sound = Sounds.Get(command.Id);
+                if(sound && sound->m_CacheEntry) break;
+                UnloadSound(command.Id);
+                Sounds.Erase(command.Id);
+                break;
+            }
+            case CommandType::LoadSound:
+                LoadSound(command.Id, command.Priority);
+                break;
+            case CommandType::UnloadSound:
+            {
+                const Sound* sound = Sounds.Get(command.Id);
+                if(sound && sound->m_CacheEntry) break;
+                UnloadSound(command.Id);
+                break;
+            }
+            case CommandType::SetListener:
+            {
+                m_Backend->SetListener(command.Position, (command.Flags & EngineCommand::HasVelocity) ? &command.Velocity : nullptr, command.Look, command.Up);
+                m_ListenerPosition = command.Position;
+                break;
+            }
+            case CommandType::PlaySound:
+                PlaySound(command.Id, command.SoundId, command.Position, command.Value, (command.Flags & EngineCommand::OneShot) != 0, command.StartClock, command.RequestTime);
+                break;
+            case CommandType::StopChannel:
+                StopChannel(command.Id, command.Value, command.Shape);
+                break;
+            case CommandType::StopAllChannels:
+                StopAllChannels();
+                break;
+            case CommandType::SetChannelPosition:
+                SetChannel3dPosition(command.Id, command.Position);
+                break;
+            case CommandType::SetChannelVolume:
+                SetChannelVolume(command.Id, command.Value);
+                break;
+            case CommandType::PlaySounds:
+            {
+                // Adding a channel can move the others, the ids are resolved one by one.
+                const ChannelBatch& batch = *command.Channels;
+                for (uint32_t i = 0; i < batch.Count; ++i)
+                {
+                    PlaySound(batch.Ids[i], batch.SoundIds[i], batch.Positions[i], batch.Values[i], false, 0, command.RequestTime);
+                }
+                m_ChannelBatches.Delete(command.Channels);
+                command.Channels = nullptr;
+                break;
+            }
+            case CommandType::StopChannels:
+            {
+                // Waking a dormant channel moves it, same as PlaySounds.
+                const ChannelBatch& batch = *command.Channels;
+                for (uint32_t i = 0; i < batch.Count; ++i)
+                {
+                    StopChannel(batch.Ids[i], command.Value, command.Shape);
+                }
+                m_ChannelBatches.Delete(command.Channels);
+                command.Channels = nullptr;
+                break;
+            }
+            case CommandType::SetChannelPositions:
+            {
+                const ChannelBatch& batch = *command.Channels;
+                ForEachBatchChannel(batch, [this](uint32_t channel)
+                {
+                    VXM_PREFETCH(&Channels.PositionsX[channel]);
+                    VXM_PREFETCH(&Channels.PositionsY[channel]);
+                    VXM_PREFETCH(&Channels.PositionsZ[channel]);
+                    VXM_PREFETCH(&Channels.Flags[channel]);
+                }, [this, &batch](uint32_t channel, uint32_t i)
+                {
+                    SetChannel3dPosition(channel, batch.Ids[i], batch.Positions[i]);
+                });
+                m_ChannelBatches.Delete(command.Channels);
+                command.Channels = nullptr;
+                break;
+            }
+            case CommandType::SetChannelVolumes:
+            {
+                const ChannelBatch& batch = *command.Channels;
+                ForEachBatchChannel(batch, [this](uint32_t channel)
+                {
+                    VXM_PREFETCH(&Channels.VolumesdB[channel]);
+                    VXM_PREFETCH(&Channels.Flags[channel]);
+                }, [this, &batch](uint32_t channel, uint32_t i)
+                {
+                    Channels.VolumesdB[channel] = batch.Values[i];
+                    Channels.Flags[channel] |= ChannelStore::VolumeDirty;
+                });
+                m_ChannelBatches.Delete(command.Channels);
+                command.Channels = nullptr;
+                break;
+            }
+        }
+    }
+
+    void AudioEngine::Tick()
+    {
+        m_Commands.Drain([this](EngineCommand& command) { ExecuteCommand(command); });
+        // The tables only grow while the commands are executed.
+        m_SoundsPeak = std::max<uint64_t>(m_SoundsPeak, Sounds.Size());
+        m_ChannelsPeak = std::max<uint64_t>(m_ChannelsPeak, Channels.Size());
+
+        PollLoads();
+        WakeDormantChannels();
+        BucketChannelsByState();
+        ComputeVirtualMask();
+        // The backend ramps the fades on its mixer, they follow its clock instead of the frame time.
+        uint64_t dspClock = m_Backend->GetDspClock();
+        float mixedSeconds = static_cast<float>(dspClock - m_DspClock) / static_cast<float>(m_SampleRate);
+        m_DspClock = dspClock;
+        // Every fade of the active channels at once, the passes below only start them and read whether they are finished.
+        Channels.StopFades.Advance(Channels.ActiveCount, mixedSeconds);
+        Channels.VirtualizeFades.Advance(Channels.ActiveCount, mixedSeconds);
+        m_StoppedChannels.clear();
+        m_SleepingChannels.clear();
+
+        UpdateStartingChannels();
+        UpdatePlayingChannels();
+        UpdateStoppingChannels();
+        UpdateVirtualizingChannels();
+        UpdateVirtualChannels();
+
+        PushChannelParameters();
+
+        RemoveStoppedChannels();
+        SleepVirtualChannels();
+        IssueLoads();
+        EnforceSampleMemoryBudget();
+
+        m_Backend->Update();
+
+        if(m_OneShotSounds.Size() > static_cast<size_t>(std::max(Config.oneShotCacheCapacity, 0)))
+        {
+            m_OneShotSounds.Trim(static_cast<size_t>(std::max(Config.oneShotCacheCapacity, 0)), [this](TypeId soundId) { EvictOneShotSound(soundId); });
+        }
+
+        PublishChannelStates();
+
+        m_PendingStats.activeChannels = Channels.ActiveCount;
+        m_PendingStats.dormantChannels = static_cast<uint32_t>(Channels.Size() - Channels.ActiveCount);
+        m_PendingStats.loadsPending = static_cast<uint32_t>(m_LoadScheduler.Size() + m_LoadingSounds.size());
+        m_PendingStats.residentSampleBytes = m_ResidentSampleBytes;
+        PublishMemoryStats();
+        IoStats io = m_Backend->ConsumeIoStats();
+        m_PendingStats.ioReads = io.reads;
+        m_PendingStats.ioBytesRead = io.bytesRead;
+        m_PendingStats.ioAverageLatencyMs = io.averageLatencyMs;
+        m_PendingStats.ioMaxLatencyMs = io.maxLatencyMs;
+        if(m_PendingStats.channelsStarted > 0) m_PendingStats.startLatencyAverageMs /= static_cast<float>(m_PendingStats.channelsStarted);
+        m_PendingStats.outputLatencyMs = m_Backend->GetOutputLatencyMs();
+        m_PendingStats.backendCalls = m_Backend->ConsumeCallCount();
+        {
+            std::lock_guard<std::mutex> lock(m_StatsMutex);
+            m_LastFrameStats = m_PendingStats;
+        }
+        m_PendingStats = {};
+    }
+
+    void AudioEngine::RemoveStoppedChannels()
+    {
+        for (TypeId channelId : m_StoppedChannels)
+        {
+            uint32_t channel = Channels.Find(channelId);
+            if(channel == SlotTable::InvalidIndex) continue;
+
+            Sound* sound = Sounds.Get(Channels.SoundIds[channel]);
+            if(sound)
+            {
+                --sound->m_ChannelCount;
+                if(sound->m_ChannelCount == 0) UpdateEvictable(Channels.SoundIds[channel], *sound);
+                if(sound->m_CacheEntry) m_OneShotSounds.Release(*sound->m_CacheEntry);
+            }
+
+            m_PlayingChannels[SlotHandle::Index(channelId)].store(NullId, std::memory_order_release);
+            Channels.Remove(channelId);
+        }
+    }
+
+    TypeId AudioEngine::AcquireOneShotSound(const SoundDefinition& definition)
+    {
+        return m_OneShotSounds.Acquire(definition, [this]() { return Sounds.AcquireHandle(); });
+    }
+
+    void AudioEngine::EvictOneShotSound(TypeId soundId)
+    {
+        // The sound may never have been created if its only play was dropped, Erase gives the id back either way.
+        UnloadSound(soundId);
+        Sounds.Erase(soundId);
+    }
+
+    void AudioEngine::PublishChannelStates()
+    {
+        // Dormant channels are virtual, they were already published as not playing before falling asleep.
+        for (uint32_t channel = 0, count = Channels.ActiveCount; channel < count; ++channel)
+        {
+            ChannelState state = Channels.States[channel];
+            bool isPlaying = Channels.Voices[channel]
+                    && (state == ChannelState::Playing || state == ChannelState::Stopping || state == ChannelState::Virtualizing);
+
+            TypeId channelId = Channels.HandleAt(channel);
+            TypeId published = isPlaying ? channelId : NullId;
+            std::atomic<TypeId>& slot = m_PlayingChannels[SlotHandle::Index(channelId)];
+            if(slot.load(std::memory_order_relaxed) != published)
+            {
+                slot.store(published, std::memory_order_release);
+            }
+        }
+    }
+
+    void AudioEngine::ReadConfigFile()
+    {
+        YAML::Node config = YAML::LoadFile(ConfigPath.string());
+        YAML::Node BackendConfig = config[AudioBackend::ConfigSection];
+        if(BackendConfig)
+        {
+            Config.numberOfChannels = BackendConfig["NumberOfChannels"].as<int>();
+            if(BackendConfig["RealVoiceBudget"]) Config.realVoiceBudget = BackendConfig["RealVoiceBudget"].as<int>();
+            if(BackendConfig["SpatialCellSize"]) Config.spatialCellSize = BackendConfig["SpatialCellSize"].as<float>();
+            if(BackendConfig["MaxChannels"]) Config.maxChannels = BackendConfig["MaxChannels"].as<int>();
+            if(BackendConfig["MaxSounds"]) Config.maxSounds = BackendConfig["MaxSounds"].as<int>();
+            if(BackendConfig["UseEngineThread"]) Config.useEngineThread = BackendConfig["UseEngineThread"].as<bool>();
+            if(BackendConfig["EngineTickRate"]) Config.engineTickRate = BackendConfig["EngineTickRate"].as<float>();
+            if(BackendConfig["CommandQueueCapacity"]) Config.commandQueueCapacity = BackendConfig["CommandQueueCapacity"].as<int>();
+            if(BackendConfig["OneShotCacheCapacity"]) Config.oneShotCacheCapacity = BackendConfig["OneShotCacheCapacity"].as<int>();
+            if(BackendConfig["MaxLoadsPerUpdate"]) Config.maxLoadsPerUpdate = BackendConfig["MaxLoadsPerUpdate"].as<int>();
+            if(BackendConfig["SampleMemoryBudget"]) Config.sampleMemoryBudget = BackendConfig["SampleMemoryBudget"].as<uint64_t>();
+            if(BackendConfig["SoundPacks"]) Config.soundPacks = BackendConfig["SoundPacks"].as<std::vector<std::string>>();
+            if(BackendConfig["UseAsyncFileSystem"]) Config.useAsyncFileSystem = BackendConfig["UseAsyncFileSystem"].as<bool>();
+            if(BackendConfig["IoThreads"]) Config.ioThreads = BackendConfig["IoThreads"].as<int>();
+            if(BackendConfig["FmodMemoryPoolSize"]) Config.fmodMemoryPoolSize = BackendConfig["FmodMemoryPoolSize"].as<uint32_t>();
+            if(BackendConfig["SoundDefinitionPoolCapacity"]) Config.soundDefinitionPoolCapacity = BackendConfig["SoundDefinitionPoolCapacity"].as<int>();
+            if(BackendConfig["ChannelBatchPoolCapacity"]) Config.channelBatchPoolCapacity = BackendConfig["ChannelBatchPoolCapacity"].as<int>();
+            if(BackendConfig["DspBufferLength"]) Config.dspBufferLength = BackendConfig["DspBufferLength"].as<uint32_t>();
+            if(BackendConfig["DspBufferCount"]) Config.dspBufferCount = BackendConfig["DspBufferCount"].as<int>();
+            if(BackendConfig["SampleRate"]) Config.sampleRate = BackendConfig["SampleRate"].as<int>();
+            if(BackendConfig["SoftwareChannels"]) Config.softwareChannels = BackendConfig["SoftwareChannels"].as<int>();
+            if(BackendConfig["SpeakerMode"]) Config.speakerMode = SpeakerModeFromName(BackendConfig["SpeakerMode"].as<std::string>());
+            if(BackendConfig["MaxMpegCodecs"]) Config.maxMpegCodecs = BackendConfig["MaxMpegCodecs"].as<int>();
+            if(BackendConfig["MaxAdpcmCodecs"]) Config.maxAdpcmCodecs = BackendConfig["MaxAdpcmCodecs"].as<int>();
+            if(BackendConfig["MaxXmaCodecs"]) Config.maxXmaCodecs = BackendConfig["MaxXmaCodecs"].as<int>();
+            if(BackendConfig["MaxVorbisCodecs"]) Config.maxVorbisCodecs = BackendConfig["MaxVorbisCodecs"].as<int>();
+            if(BackendConfig["MaxAt9Codecs"]) Config.maxAt9Codecs = BackendConfig["MaxAt9Codecs"].as<int>();
+            if(BackendConfig["MaxFadpcmCodecs"]) Config.maxFadpcmCodecs = BackendConfig["MaxFadpcmCodecs"].as<int>();
+            if(BackendConfig["MaxOpusCodecs"]) Config.maxOpusCodecs = BackendConfig["MaxOpusCodecs"].as<int>();
+            if(BackendConfig["OutputMode"]) Config.outputMode = OutputModeFromName(BackendConfig["OutputMode"].as<std::string>());
+            if(BackendConfig["WavWriterPath"]) Config.wavWriterPath = BackendConfig["WavWriterPath"].as<std::string>();
+        }
+    }
+
+    void AudioEngine::WriteConfigFile()
+    {
+        // Only called when the file doesn't exist, it is created with every value so it can be tuned.
+        YAML::Node config;
+        YAML::Node BackendConfig = config[AudioBackend::ConfigSection];
+        BackendConfig["NumberOfChannels"] = Config.numberOfChannels;
+        BackendConfig["RealVoiceBudget"] = Config.realVoiceBudget;
+        BackendConfig["SpatialCellSize"] = Config.spatialCellSize;
+        BackendConfig["MaxChannels"] = Config.maxChannels;
+        BackendConfig["MaxSounds"] = Config.maxSounds;
+        BackendConfig["UseEngineThread"] = Config.useEngineThread;
+        BackendConfig["EngineTickRate"] = Config.engineTickRate;
+        BackendConfig["CommandQueueCapacity"] = Config.commandQueueCapacity;
+        BackendConfig["OneShotCacheCapacity"] = Config.oneShotCacheCapacity;
+        BackendConfig["MaxLoadsPerUpdate"] = Config.maxLoadsPerUpdate;
+        BackendConfig["SampleMemoryBudget"] = Config.sampleMemoryBudget;
+        BackendConfig["SoundPacks"] = Config.soundPacks;
+        BackendConfig["UseAsyncFileSystem"] = Config.useAsyncFileSystem;
+        BackendConfig["IoThreads"] = Config.ioThreads;
+        BackendConfig["FmodMemoryPoolSize"] = Config.fmodMemoryPoolSize;
+        BackendConfig["SoundDefinitionPoolCapacity"] = Config.soundDefinitionPoolCapacity;
+        BackendConfig["ChannelBatchPoolCapacity"] = Config.channelBatchPoolCapacity;
+        BackendConfig["DspBufferLength"] = Config.dspBufferLength;
+        BackendConfig["DspBufferCount"] = Config.dspBufferCount;
+        BackendConfig["SampleRate"] = Config.sampleRate;
+        BackendConfig["SoftwareChannels"] = Config.softwareChannels;
+        BackendConfig["SpeakerMode"] = SpeakerModeName(Config.speakerMode);
+        BackendConfig["MaxMpegCodecs"] = Config.maxMpegCodecs;
+        BackendConfig["MaxAdpcmCodecs"] = Config.maxAdpcmCodecs;
+        BackendConfig["MaxXmaCodecs"] = Config.maxXmaCodecs;
+        BackendConfig["MaxVorbisCodecs"] = Config.maxVorbisCodecs;
+        BackendConfig["MaxAt9Codecs"] = Config.maxAt9Codecs;
+        BackendConfig["MaxFadpcmCodecs"] = Config.maxFadpcmCodecs;
+        BackendConfig["MaxOpusCodecs"] = Config.maxOpusCodecs;
+        BackendConfig["OutputMode"] = s_OutputModeNames[static_cast<size_t>(Config.outputMode)];
+        BackendConfig["WavWriterPath"] = Config.wavWriterPath;
+
+        std::ofstream file(ConfigPath);
+        if(file) file << config;
+        else std::cerr << "Voxaudio ERROR : can't write the config file " << ConfigPath.string() << std::endl;
+    }
+
+    void AudioEngine::LoadSound(TypeId soundId, LoadPriority priority)
+    {
+        Sound* sound = Sounds.Get(soundId);
+        if(!sound) return;
+
+        // A prefetched sound must not be the first one evicted.
+        if(sound->m_IsEvictable) UpdateEvictable(soundId, *sound);
+        switch (sound->m_LoadState)
+        {
+            case SoundLoadState::Unloaded:
+            case SoundLoadState::Error:
+                sound->m_LoadState = SoundLoadState::Queued;
+                sound->m_LoadPriority = priority;
+                sound->m_LoadRequestTime = std::chrono::steady_clock::now();
+                m_LoadScheduler.Request(soundId, priority);
+                break;
+            case SoundLoadState::Queued:
+                // Raise the priority, the old entry is skipped when it is reached.
+                if(priority < sound->m_LoadPriority)
+                {
+                    sound->m_LoadPriority = priority;
+                    m_LoadScheduler.Request(soundId, priority);
+                }
+                break;
+            case SoundLoadState::Loading:
+            case SoundLoadState::Ready:
+                break;
+        }
+    }
+
+    void AudioEngine::IssueLoads()
+    {
+        uint32_t maxLoads = static_cast<uint32_t>(std::max(Config.maxLoadsPerUpdate, 1));
+        m_PendingStats.loadsIssued += m_LoadScheduler.Issue(maxLoads, [this](TypeId soundId, LoadPriority priority) { return StartLoad(soundId, priority); });
+    }
+
+    bool AudioEngine::StartLoad(TypeId soundId, LoadPriority priority)
+    {
+        Sound* sound = Sounds.Get(soundId);
+        // Unregistered, unloaded or requested again with a higher priority since the request was queued.
+        if(!sound || sound->m_LoadState != SoundLoadState::Queued || sound->m_LoadPriority != priority) return false;
+
+        SoundDefinition& definition = sound->m_Definition;
+
+        // Without real time the load blocks, the sound is ready at the next update whatever the speed of the disk.
+        sound->m_Sound = m_Backend->CreateSound(definition, priority, FindPackEntry(definition.name), Config.IsNonRealTime());
+        if(!sound->m_Sound)
+        {
+            sound->m_LoadState = SoundLoadState::Error;
+            WakeWaitingChannels(*sound, ChannelState::Stopping);
+            return true;
+        }
+
+        sound->m_LoadState = SoundLoadState::Loading;
+        m_LoadingSounds.push_back(soundId);
+        return true;
+    }
+
+    void AudioEngine::PollLoads()
+    {
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < m_LoadingSounds.size();)
+        {
+            Sound* sound = Sounds.Get(m_LoadingSounds[i]);
+            if(sound && sound->m_LoadState == SoundLoadState::Loading)
+            {
+                BackendLoadState loadState = m_Backend->GetLoadState(sound->m_Sound);
+                if(loadState == BackendLoadState::Loading)
+                {
+                    ++i;
+                    continue;
+                }
+
+                if(loadState == BackendLoadState::Error)
+                {
+                    m_Backend->ReleaseSound(sound->m_Sound);
+                    sound->m_Sound = {};
+                    sound->m_LoadState = SoundLoadState::Error;
+                    WakeWaitingChannels(*sound, ChannelState::Stopping);
+                }
+                else
+                {
+                    sound->m_LoadState = SoundLoadState::Ready;
+                    sound->m_ResidentBytes = m_Backend->FinishLoad(sound->m_Sound, sound->m_Definition);
+                    m_ResidentSampleBytes += sound->m_ResidentBytes;
+
+                    float latencyMs = std::chrono::duration<float, std::milli>(now - sound->m_LoadRequestTime).count();
+                    ++m_PendingStats.loadsCompleted;
+                    m_PendingStats.maxLoadLatencyMs = std::max(m_PendingStats.maxLoadLatencyMs, latencyMs);
+                    WakeWaitingChannels(*sound, ChannelState::ToPlay);
+                    UpdateEvictable(m_LoadingSounds[i], *sound);
+                }
+            }
+
+            m_LoadingSounds[i] = m_LoadingSounds.back();
+            m_LoadingSounds.pop_back();
+        }
+    }
+
+    void AudioEngine::EnforceSampleMemoryBudget()
+    {
+        if(Config.sampleMemoryBudget == 0) return;
+
+        // A played sound that was evicted is requested again by its channel, like a sound that was never loaded.
+        while (m_ResidentSampleBytes > Config.sampleMemoryBudget && m_LeastRecentEvictable != NullId)
+        {
+            UnloadSound(m_LeastRecentEvictable);
+            ++m_PendingStats.soundsEvicted;
+        }
+    }
+
+    void AudioEngine::UpdateEvictable(TypeId soundId, Sound& sound)
+    {
+        UnlinkEvictable(sound);
+        if(sound.m_LoadState != SoundLoadState::Ready || sound.m_ChannelCount > 0 || sound.m_Definition.pinned) return;
+
+        sound.m_IsEvictable = true;
+        sound.m_EvictablePrevious = NullId;
+        sound.m_EvictableNext = m_MostRecentEvictable;
+        if(Sound* next = Sounds.Get(m_MostRecentEvictable)) next->m_EvictablePrevious = soundId;
+        else m_LeastRecentEvictable = soundId;
+        m_MostRecentEvictable = soundId;
+    }
+
+    void AudioEngine::UnlinkEvictable(Sound& sound)
+    {
+        if(!sound.m_IsEvictable) return;
+
+        if(Sound* previous = Sounds.Get(sound.m_EvictablePrevious)) previous->m_EvictableNext = sound.m_EvictableNext;
+        else m_MostRecentEvictable = sound.m_EvictableNext;
+        if(Sound* next = Sounds.Get(sound.m_EvictableNext)) next->m_EvictablePrevious = sound.m_EvictablePrevious;
+        else m_LeastRecentEvictable = sound.m_EvictablePrevious;
+        sound.m_IsEvictable = false;
+        sound.m_EvictablePrevious = NullId;
+        sound.m_EvictableNext = NullId;
+    }
+
+    std::span<const std::byte> AudioEngine::FindPackEntry(std::string_view name) const
+    {
+        for (auto it = m_SoundPacks.rbegin(); it != m_SoundPacks.rend(); ++it)
+        {
+            std::span<const std::byte> entry = (*it)->Find(name);
+            if(!entry.empty()) return entry;
+        }
+        return {};
+    }
+
+    void AudioEngine::WakeWaitingChannels(Sound& sound, ChannelState state)
+    {
+        for (TypeId channelId : sound.m_WaitingChannels)
+        {
+            uint32_t channel = Channels.Find(channelId);
+            if(channel == SlotTable::InvalidIndex || Channels.States[channel] != ChannelState::Loading) continue;
+            Channels.States[channel] = state;
+        }
+        sound.m_WaitingChannels.clear();
+    }
+
+    void AudioEngine::UnloadSound(TypeId soundId)
+    {
+        Sound* sound = Sounds.Get(soundId);
+        if(!sound) return;
+
+        // A loading sound is dropped from m_LoadingSounds by the next poll, a queued one is skipped by the scheduler.
+        if(sound->m_Sound)
+        {
+            m_Backend->ReleaseSound(sound->m_Sound);
+            sound->m_Sound = {};
+        }
+        m_ResidentSampleBytes -= sound->m_ResidentBytes;
+        sound->m_ResidentBytes = 0;
+        sound->m_LoadState = SoundLoadState::Unloaded;
+        UnlinkEvictable(*sound);
+        // The waiting channels request the sound again.
+        WakeWaitingChannels(*sound, ChannelState::ToPlay);
+    }
+
+    bool AudioEngine::SoundIsLoaded(TypeId soundId) const {
+        const Sound* sound = Sounds.Get(soundId);
+        if(!sound) return false;
+
+        return sound->m_LoadState == SoundLoadState::Ready;
+    }
+
+    void AudioEngine::PlaySound(TypeId channelId, TypeId soundId, const Vector3& position, float volumedB, bool hasCacheReference, uint64_t startClock, std::chrono::steady_clock::time_point requestTime)
+    {
+        Sound* sound = Sounds.Get(soundId);
+        const SoundDefinition* cachedDefinition;
+        SoundCache::Entry* cacheEntry;
+        if (!sound && m_OneShotSounds.Find(soundId, cachedDefinition, cacheEntry))
+        {
+            // First play of a one shot sound, the cache gave the id but nobody created the sound yet.
+            Sounds.Insert(soundId, *cachedDefinition, cacheEntry);
+            sound = Sounds.Get(soundId);
+        }
+
+        if (!sound)
+        {
+            // Give the id back, the channel will never exist.
+            Channels.Remove(channelId);
+            if(hasCacheReference) m_OneShotSounds.Release(soundId);
+            return;
+        }
+
+        // Every channel of a cached sound holds a reference, released when the channel is removed.
+        if(sound->m_CacheEntry && !hasCacheReference) sound->m_CacheEntry->References.fetch_add(1, std::memory_order_relaxed);
+
+        // The voice is created by the first update of the channel.
+        if(!Channels.Add(channelId, soundId, sound->m_Definition, position, volumedB, sound->m_CacheEntry ? ChannelStore::OneShot : ChannelStore::None, startClock, requestTime))
+        {
+            if(sound->m_CacheEntry) m_OneShotSounds.Release(*sound->m_CacheEntry);
+            return;
+        }
+        ++sound->m_ChannelCount;
+        UnlinkEvictable(*sound);
+    }
+
+    void AudioEngine::StopChannel(TypeId channelId, float fadeTimeSeconds, FadeShape fadeShape)
+    {
+        uint32_t channel = Channels.Find(channelId);
+        if(channel == SlotTable::InvalidIndex) return;
+
+        // A dormant channel is never updated, it has to be active to go through the stopping state.
+        channel = WakeChannel(channel);
+        Channels.Flags[channel] |= ChannelStore::StopRequested;
+        // Nothing to fade, don't wait for the load to complete.
+        if(Channels.States[channel] == ChannelState::Loading) Channels.States[channel] = ChannelState::Stopping;
+        if(fadeTimeSeconds <= 0.0f)
+        {
+            Channels.StopFades.Start(channel, 0.0f, SILENCE_dB, 0.0f, fadeShape);
+            StopVoice(channel);
+        }
+        else
+        {
+            StartFade(channel, Channels.StopFades, 0.0f, SILENCE_dB, fadeTimeSeconds, fadeShape);
+        }
+    }
+
+    void AudioEngine::StopAllChannels()
+    {
+        // Everything become active, no need to move the channels one by one.
+        m_DormantGrid.Clear();
+        m_DormantDistanceClasses.fill(0);
+        Channels.ActiveCount = static_cast<uint32_t>(Channels.Size());
+
+        for (uint32_t channel = 0; channel < Channels.Size(); ++channel)
+        {
+            Channels.Flags[channel] &= ~ChannelStore::Moved;
+            Channels.Flags[channel] |= ChannelStore::StopRequested;
+            if(Channels.States[channel] == ChannelState::Loading) Channels.States[channel] = ChannelState::Stopping;
+            Channels.StopFades.Start(channel, 0.0f, SILENCE_dB, 0.0f, FadeShape::LinearDecibel);
+            StopVoice(channel);
+        }
+    }
+
+    void AudioEngine::SetChannel3dPosition(TypeId channelId, const Vector3& position)
+    {
+        uint32_t channel = Channels.Find(channelId);
+        if(channel == SlotTable::InvalidIndex) return;
+
+        SetChannel3dPosition(channel, channelId, position);
+    }
+
+    void AudioEngine::SetChannel3dPosition(uint32_t channel, TypeId channelId, const Vector3& position)
+    {
+        if(Channels.IsDormant(channel))
+        {
+            m_DormantGrid.Move(channelId, Channels.GetPosition(channel), position);
+            if(!Channels.HasFlag(channel, ChannelStore::Moved))
+            {
+                Channels.Flags[channel] |= ChannelStore::Moved;
+                m_MovedDormantChannels.push_back(channelId);
+            }
+        }
+        Channels.SetPosition(channel, position);
+        Channels.Flags[channel] |= ChannelStore::PositionDirty;
+    }
+
+    void AudioEngine::SetChannelVolume(TypeId channelId, float volumedB)
+    {
+        uint32_t channel = Channels.Find(channelId);
+        if(channel == SlotTable::InvalidIndex) return;
+
+        Channels.VolumesdB[channel] = volumedB;
+        Channels.Flags[channel] |= ChannelStore::VolumeDirty;
+    }
+
+    void AudioEngine::WakeDormantChannels()
+    {
+        m_WakingChannels.clear();
+
+        auto isInRange = [this](uint32_t channel)
+        {
+            Vector3 delta = Channels.GetPosition(channel) - m_ListenerPosition;
+            return glm::dot(delta, delta) <= Channels.MaxDistancesSq[channel];
+        };
+
+        m_DormantGrid.QuerySphere(m_ListenerPosition, ComputeDormantQueryRadius(), [&](TypeId channelId)
+        {
+            uint32_t channel = Channels.Find(channelId);
+            if(channel != SlotTable::InvalidIndex && isInRange(channel))
+            {
+                m_WakingChannels.push_back(channelId);
+            }
+        });
+
+        for (TypeId channelId : m_MovedDormantChannels)
+        {
+            uint32_t channel = Channels.Find(channelId);
+            if(channel == SlotTable::InvalidIndex || !Channels.IsDormant(channel)) continue;
+
+            Channels.Flags[channel] &= ~ChannelStore::Moved;
+            if(isInRange(channel))
+            {
+                m_WakingChannels.push_back(channelId);
+            }
+        }
+        m_MovedDormantChannels.clear();
+
+        // The woken up channels are still virtual, the usual passes will devirtualize them.
+        for (TypeId channelId : m_WakingChannels)
+        {
+            uint32_t channel = Channels.Find(channelId);
+            if(channel == SlotTable::InvalidIndex) continue;
+            WakeChannel(channel);
+        }
+    }
+
+    void AudioEngine::SleepVirtualChannels()
+    {
+        for (TypeId channelId : m_SleepingChannels)
+        {
+            uint32_t channel = Channels.Find(channelId);
+            if(channel == SlotTable::InvalidIndex || Channels.IsDormant(channel)) continue;
+
+            channel = Channels.Sleep(channel);
+            m_DormantGrid.Insert(channelId, Channels.GetPosition(channel));
+            ++m_DormantDistanceClasses[DormantDistanceClass(Channels.MaxDistancesSq[channel])];
+        }
+    }
+
+    uint32_t AudioEngine::WakeChannel(uint32_t channel)
+    {
+        if(!Channels.IsDormant(channel)) return channel;
+
+        m_DormantGrid.Remove(Channels.HandleAt(channel), Channels.GetPosition(channel));
+        --m_DormantDistanceClasses[DormantDistanceClass(Channels.MaxDistancesSq[channel])];
+        Channels.Flags[channel] &= ~ChannelStore::Moved;
+        return Channels.Wake(channel);
+    }
+
+    float AudioEngine::ComputeDormantQueryRadius() const
+    {
+        for (size_t distanceClass = DormantDistanceClassCount; distanceClass-- > 0;)
+        {
+            if(m_DormantDistanceClasses[distanceClass] == 0) continue;
+            // The last class has no bound, its radius is large enough for the grid to list every element instead of its cells.
+            return std::ldexp(1.0f, static_cast<int>(distanceClass));
+        }
+        return 0.0f;
+    }
+
+    uint32_t AudioEngine::DormantDistanceClass(float maxDistanceSq)
+    {
+        int exponent = 0;
+        std::frexp(std::sqrt(maxDistanceSq), &exponent);
+        return static_cast<uint32_t>(std::clamp(exponent, 0, static_cast<int>(DormantDistanceClassCount) - 1));
+    }
+
+    void AudioEngine::BucketChannelsByState()
+    {
+        for (auto& bucket : m_StateBuckets)
+        {
+            bucket.clear();
+        }
+
+        const ChannelState* states = Channels.States.data();
+        for (uint32_t channel = 0, count = Channels.ActiveCount; channel < count; ++channel)
+        {
+            m_StateBuckets[static_cast<size_t>(states[channel])].push_back(channel);
+        }
+    }
+
+    void AudioEngine::ComputeVirtualMask()
+    {
+        // The distance test of every channel is done here in one go, the passes only read the mask.
+        // Only the active channels, the dormant ones are handled by the spatial index.
+        m_VirtualMask.resize(Channels.ActiveCount);
+        Simd::ComputeOutOfRangeMask(Channels.PositionsX.data(), Channels.PositionsY.data(), Channels.PositionsZ.data(),
+                                    Channels.MaxDistancesSq.data(), Channels.ActiveCount, m_ListenerPosition, m_VirtualMask.data());
+
+        ApplyRealVoiceBudget();
+    }
+
+    void AudioEngine::ApplyRealVoiceBudget()
+    {
+        int budget = Config.realVoiceBudget > 0 ? Config.realVoiceBudget : Config.numberOfChannels;
+
+        // Stopping channels and playing one shots keep their voice until they end, they can't be stolen.
+        budget -= static_cast<int>(m_StateBuckets[static_cast<size_t>(ChannelState::Stopping)].size());
+
+        m_VoiceCandidates.clear();
+        for (ChannelState state : {ChannelState::Initialize, ChannelState::ToPlay, ChannelState::Loading, ChannelState::Devirtualize,
+                                   ChannelState::Playing, ChannelState::Virtualizing, ChannelState::Virtual})
+        {
+            bool isReal = state == ChannelState::Playing || state == ChannelState::Virtualizing;
+            for (uint32_t channel : m_StateBuckets[static_cast<size_t>(state)])
+            {
+                if(m_VirtualMask[channel]) continue;
+                if(isReal && Channels.HasFlag(channel, ChannelStore::OneShot))
+                {
+                    --budget;
+                    continue;
+                }
+                m_VoiceCandidates.push_back(channel);
+            }
+        }
+
+        budget = std::max(budget, 0);
+        if(m_VoiceCandidates.size() <= static_cast<size_t>(budget)) return;
+
+        // The rolloff gains of every candidate are converted to dB at once.
+        m_RolloffGains.resize(m_VoiceCandidates.size());
+        for (size_t i = 0; i < m_VoiceCandidates.size(); ++i)
+        {
+            m_RolloffGains[i] = ComputeRolloffGain(m_VoiceCandidates[i]);
+        }
+        Helper::VolumeTodB(m_RolloffGains, m_RolloffGains);
+
+        m_Audibilities.resize(Channels.ActiveCount);
+        for (size_t i = 0; i < m_VoiceCandidates.size(); ++i)
+        {
+            m_Audibilities[m_VoiceCandidates[i]] = ComputeAudibility(m_VoiceCandidates[i], m_RolloffGains[i]);
+        }
+
+        // Only the split between the N most audible and the others matters, no need for a full sort.
+        auto nth = m_VoiceCandidates.begin() + budget;
+        std::nth_element(m_VoiceCandidates.begin(), nth, m_VoiceCandidates.end(), [this](uint32_t a, uint32_t b)
+        {
+            return m_Audibilities[a] > m_Audibilities[b];
+        });
+
+        for (auto it = nth; it != m_VoiceCandidates.end(); ++it)
+        {
+            m_VirtualMask[*it] |= OverBudget;
+        }
+    }
+
+    // Linear gain of the distance attenuation at the listener position.
+    // It doesn't need to match the backend exactly, only to order the channels.
+    float AudioEngine::ComputeRolloffGain(uint32_t channel) const
+    {
+        float distance = glm::distance(Channels.GetPosition(channel), m_ListenerPosition);
+        float minDistance = Channels.MinDistances[channel];
+        float maxDistance = std::sqrt(Channels.MaxDistancesSq[channel]);
+        if(distance <= minDistance) return 1.0f;
+
+        // Inverse tapered rolloff: inverse distance from minDistance, tapered to silence at maxDistance.
+        float inverse = minDistance > 0.0f ? minDistance / distance : 1.0f;
+        float taper = maxDistance > minDistance ? 1.0f - (distance - minDistance) / (maxDistance - minDistance) : 0.0f;
+        return inverse * std::max(taper, 0.0f);
+    }
+
+    // Estimation of how loud the channel is at the listener position, in dB.
+    // A silent rolloff is about -758 dB, below any audible channel.
+    float AudioEngine::ComputeAudibility(uint32_t channel, float rolloffdB) const
+    {
+        float audibilitydB = Channels.VolumesdB[channel] + Channels.Priorities[channel] + rolloffdB;
+
+        ChannelState state = Channels.States[channel];
+        if(state == ChannelState::Playing || state == ChannelState::Virtualizing)
+        {
+            audibilitydB += REAL_VOICE_HYSTERESIS_dB;
+        }
+
+        return audibilitydB;
+    }
+
+    void AudioEngine::UpdateStartingChannels()
+    {
+        for (ChannelState startingState : {ChannelState::Initialize, ChannelState::ToPlay, ChannelState::Devirtualize})
+        {
+            for (uint32_t channel : m_StateBuckets[static_cast<size_t>(startingState)])
+            {
+                ChannelState& state = Channels.States[channel];
+
+                if(Channels.HasFlag(channel, ChannelStore::StopRequested))
+                {
+                    state = ChannelState::Stopping;
+                    continue;
+                }
+
+                if(ShouldBeVirtual(channel, true))
+                {
+                    state = Channels.HasFlag(channel, ChannelStore::OneShot) ? ChannelState::Stopping : ChannelState::Virtual;
+                    continue;
+                }
+
+                TypeId soundId = Channels.SoundIds[channel];
+                Sound* sound = Sounds.Get(soundId);
+                if(!sound || sound->m_LoadState == SoundLoadState::Error)
+                {
+                    state = ChannelState::Stopping;
+                    continue;
+                }
+
+                if(sound->m_LoadState != SoundLoadState::Ready)
+                {
+                    // Parked until the load completes, the Loading state has no pass.
+                    LoadSound(soundId, LoadPriority::Imminent);
+                    sound->m_WaitingChannels.push_back(Channels.HandleAt(channel));
+                    state = ChannelState::Loading;
+                    continue;
+                }
+
+                // The voice is created paused and waits for its start clock.
+                // A channel devirtualized after its start plays at once.
+                // The backends hold numberOfChannels voices: while the voices fading out fill them the channel waits for the next update.
+                if(m_VoiceCount >= static_cast<uint32_t>(std::max(Config.numberOfChannels, 1))) continue;
+                uint64_t startClock = Channels.StartClocks[channel] > m_DspClock ? Channels.StartClocks[channel] : 0;
+                AudioBackend::VoiceHandle& voice = Channels.Voices[channel];
+                voice = m_Backend->StartVoice(sound->m_Sound, startClock);
+                if(!voice)
+                {
+                    state = ChannelState::Stopping;
+                    continue;
+                }
+                ++m_VoiceCount;
+
+                if(state == ChannelState::Devirtualize)
+                {
+                    //Fade In for Virtualize
+                    StartFade(channel, Channels.VirtualizeFades, SILENCE_dB, 0.0f, VIRTUALIZE_FADE_TIME, FadeShape::LinearDecibel);
+                }
+                else if(Channels.StartClocks[channel] == 0 && Channels.RequestTimes[channel] != std::chrono::steady_clock::time_point{})
+                {
+                    // Summed here, averaged when the stats are published.
+                    float latencyMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - Channels.RequestTimes[channel]).count();
+                    ++m_PendingStats.channelsStarted;
+                    m_PendingStats.startLatencyAverageMs += latencyMs;
+                    m_PendingStats.startLatencyMaxMs = std::max(m_PendingStats.startLatencyMaxMs, latencyMs);
+                }
+                state = ChannelState::Playing;
+
+                // A new voice knows nothing, everything is pushed before it is unpaused.
+                Channels.Flags[channel] |= ChannelStore::ParametersDirty;
+            }
+        }
+    }
+
+    void AudioEngine::UpdatePlayingChannels()
+    {
+        for (uint32_t channel : m_StateBuckets[static_cast<size_t>(ChannelState::Playing)])
+        {
+            if(!IsChannelPlaying(channel) || Channels.HasFlag(channel, ChannelStore::StopRequested))
+            {
+                Channels.States[channel] = ChannelState::Stopping;
+                continue;
+            }
+
+            if(ShouldBeVirtual(channel, false))
+            {
+                StartFade(channel, Channels.VirtualizeFades, SILENCE_dB, VIRTUALIZE_FADE_TIME, FadeShape::LinearDecibel);
+                Channels.States[channel] = ChannelState::Virtualizing;
+            }
+        }
+    }
+
+    void AudioEngine::UpdateStoppingChannels()
+    {
+        for (uint32_t channel : m_StateBuckets[static_cast<size_t>(ChannelState::Stopping)])
+        {
+            // A voice that ended before its fade is released as well, the backend keeps it until StopVoice.
+            if(Channels.StopFades.IsFinished(channel) || !IsChannelPlaying(channel))
+            {
+                StopVoice(channel);
+                Channels.States[channel] = ChannelState::Stopped;
+                m_StoppedChannels.push_back(Channels.HandleAt(channel));
+            }
+        }
+
+        // Channels can't stay stopped, they are removed at the end of the frame.
+        for (uint32_t channel : m_StateBuckets[static_cast<size_t>(ChannelState::Stopped)])
+        {
+            m_StoppedChannels.push_back(Channels.HandleAt(channel));
+        }
+    }
+
+    void AudioEngine::UpdateVirtualizingChannels()
+    {
+        for (uint32_t channel : m_StateBuckets[static_cast<size_t>(ChannelState::Virtualizing)])
+        {
+            if(Channels.HasFlag(channel, ChannelStore::StopRequested))
+            {
+                Channels.States[channel] = ChannelState::Stopping;
+            }
+            else if(!ShouldBeVirtual(channel, false))
+            {
+                StartFade(channel, Channels.VirtualizeFades, 0.0f, VIRTUALIZE_FADE_TIME, FadeShape::LinearDecibel);
+                Channels.States[channel] = ChannelState::Playing;
+            }
+            else if(Channels.VirtualizeFades.IsFinished(channel))
+            {
+                StopVoice(channel);
+                Channels.States[channel] = ChannelState::Virtual;
+            }
+        }
+    }
+
+    void AudioEngine::UpdateVirtualChannels()
+    {
+        for (uint32_t channel : m_StateBuckets[static_cast<size_t>(ChannelState::Virtual)])
+        {
+            if(Channels.HasFlag(channel, ChannelStore::StopRequested))
+            {
+                Channels.States[channel] = ChannelState::Stopping;
+            }
+            else if(!ShouldBeVirtual(channel, false))
+            {
+                Channels.States[channel] = ChannelState::Devirtualize;
+            }
+            else if(m_VirtualMask[channel] == OutOfRange)
+            {
+                // Out of range (and not only waiting for a voice), it can leave the per frame update.
+                m_SleepingChannels.push_back(Channels.HandleAt(channel));
+            }
+        }
+    }
+
+    bool AudioEngine::IsChannelPlaying(uint32_t channel)
+    {
+        AudioBackend::VoiceHandle voice = Channels.Voices[channel];
+        if(!voice) return false;
+
+        return m_Backend->IsVoicePlaying(voice);
+    }
+
+    void AudioEngine::StopVoice(uint32_t channel)
+    {
+        AudioBackend::VoiceHandle& voice = Channels.Voices[channel];
+        if(!voice) return;
+
+        m_Backend->StopVoice(voice);
+        voice = {};
+        --m_VoiceCount;
+        Channels.Flags[channel] &= ~ChannelStore::ParametersDirty;
+    }
+
+    void AudioEngine::StartFade(uint32_t channel, FadeTable& fades, float fromVolumedB, float toVolumedB, float fadeTimeSeconds, FadeShape shape)
+    {
+        fades.Start(channel, fromVolumedB, toVolumedB, fadeTimeSeconds, shape);
+        ScheduleFadePoints(channel);
+    }
+
+    void AudioEngine::StartFade(uint32_t channel, FadeTable& fades, float toVolumedB, float fadeTimeSeconds, FadeShape shape)
+    {
+        fades.Start(channel, toVolumedB, fadeTimeSeconds, shape);
+        ScheduleFadePoints(channel);
+    }
+
+    void AudioEngine::ScheduleFadePoints(uint32_t channel)
+    {
+        AudioBackend::VoiceHandle voice = Channels.Voices[channel];
+        if(!voice) return;
+
+        // A voice has a single envelope, it gets the product of both fades sampled until the longest one ends.
+        const FadeTable& stopFades = Channels.StopFades;
+        const FadeTable& virtualizeFades = Channels.VirtualizeFades;
+        float remaining = std::max(stopFades.GetRemainingTime(channel), virtualizeFades.GetRemainingTime(channel));
+
+        std::array<FadePoint, FADE_POINT_COUNT + 1> points;
+        points[0] = {m_DspClock, stopFades.Gains[channel] * virtualizeFades.Gains[channel]};
+        size_t pointCount = 1;
+        if(remaining > 0.0f)
+        {
+            for (int point = 1; point <= FADE_POINT_COUNT; ++point)
+            {
+                float time = remaining * static_cast<float>(point) / FADE_POINT_COUNT;
+                uint64_t clock = m_DspClock + static_cast<uint64_t>(time * static_cast<float>(m_SampleRate));
+                points[pointCount++] = {clock, stopFades.GainAfter(channel, time) * virtualizeFades.GainAfter(channel, time)};
+            }
+        }
+        m_Backend->SetVoiceFadePoints(voice, std::span<const FadePoint>(points.data(), pointCount));
+    }
+
+    void AudioEngine::PushChannelParameters()
+    {
+        uint8_t* flags = Channels.Flags.data();
+        // Only the dirty volumes are converted, gathered so they still go through the SIMD conversion in one call.
+        m_DirtyVolumeChannels.clear();
+        m_DirtyVolumesdB.clear();
+        for (uint32_t channel = 0, count = Channels.ActiveCount; channel < count; ++channel)
+        {
+            if((flags[channel] & ChannelStore::VolumeDirty) == 0 || !Channels.Voices[channel]) continue;
+            m_DirtyVolumeChannels.push_back(channel);
+            m_DirtyVolumesdB.push_back(Channels.VolumesdB[channel]);
+        }
+        m_ChannelGains.resize(m_DirtyVolumeChannels.size());
+        Helper::dBToVolume(m_DirtyVolumesdB, m_ChannelGains);
+        // Before the unpause below, so a starting voice is never heard at its previous volume.
+        for (size_t i = 0; i < m_DirtyVolumeChannels.size(); ++i)
+        {
+            // The fades are applied by the fade points, they multiply this volume.
+            m_Backend->SetVoiceVolume(Channels.Voices[m_DirtyVolumeChannels[i]], m_ChannelGains[i]);
+        }
+        m_PendingStats.volumeUpdates += static_cast<uint32_t>(m_DirtyVolumeChannels.size());
+
+        for (uint32_t channel = 0, count = Channels.ActiveCount; channel < count; ++channel)
+        {
+            if((flags[channel] & ChannelStore::ParametersDirty) == 0) continue;
+
+            AudioBackend::VoiceHandle voice = Channels.Voices[channel];
+            if(voice)
+            {
+                if(flags[channel] & ChannelStore::PositionDirty)
+                {
+                    m_Backend->SetVoicePosition(voice, Channels.GetPosition(channel));
+                    ++m_PendingStats.positionUpdates;
+                }
+                if(flags[channel] & ChannelStore::PendingUnpause)
+                {
+                    m_Backend->SetVoicePaused(voice, false);
+                }
+            }
+            // Without voice there is nothing to update, the next one will get everything anyway.
+            flags[channel] &= ~ChannelStore::ParametersDirty;
+        }
+    }
+
+    // It should be some calculation to see if the sound is still worth playing.
+    // Maybe a lookup in the sound defintion to see if the sound is worth virtualizing.
+    // The mask combine the distance check and the real voice budget (see ComputeVirtualMask).
+    bool AudioEngine::ShouldBeVirtual(uint32_t channel, bool allowVirtualOneShot) const
+    {
+        if(!allowVirtualOneShot && Channels.HasFlag(channel, ChannelStore::OneShot)) return false;
+
+        return m_VirtualMask[channel] != 0;
+    }
+
+    Sound::Sound(SoundDefinition && def, SoundCache::Entry* cacheEntry) : m_Sound(), m_Definition(std::move(def)), m_CacheEntry(cacheEntry)
+    {
+    }
+
+    Sound::Sound(const SoundDefinition & def, SoundCache::Entry* cacheEntry) : m_Sound(), m_Definition(def), m_CacheEntry(cacheEntry)
+    {
+
+    }
+}
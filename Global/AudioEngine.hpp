@@ -0,0 +1,236 @@
+//
+// Created by ianpo on 04/11/2023.
+//
+
+#pragma once
+
+#include "Voxaudio.hpp"
+#include "SlotMap.hpp"
+#include "ChannelStore.hpp"
+#include "SpatialHashGrid.hpp"
+#include "CommandQueue.hpp"
+#include "SoundCache.hpp"
+#include "LoadScheduler.hpp"
+#include "SoundPack.hpp"
+#include "AudioBackend.hpp"
+#include "EngineConfig.hpp"
+#include "FixedPool.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <filesystem>
+#include <string>
+
+namespace Voxymore::Audio
+{
+    enum class SoundLoadState : uint8_t {Unloaded, Queued, Loading, Ready, Error};
+
+    struct Sound
+    {
+        Sound(const SoundDefinition&, SoundCache::Entry* cacheEntry = nullptr);
+        Sound(SoundDefinition&&, SoundCache::Entry* cacheEntry = nullptr);
+
+        AudioBackend::SoundHandle m_Sound{};
+        SoundDefinition m_Definition;
+        // Set for the one shot sounds, shared through the sound cache.
+        SoundCache::Entry* m_CacheEntry = nullptr;
+
+        SoundLoadState m_LoadState = SoundLoadState::Unloaded;
+        LoadPriority m_LoadPriority = LoadPriority::Background;
+        std::chrono::steady_clock::time_point m_LoadRequestTime;
+        // Channels in the Loading state, woken up when the load completes.
+        std::vector<TypeId> m_WaitingChannels;
+
+        // Estimated memory of the loaded data, counted in the sample memory budget.
+        uint64_t m_ResidentBytes = 0;
+        // Channels (real, virtual or waiting) using the sound, only the sounds without channels can be evicted.
+        uint32_t m_ChannelCount = 0;
+        // Links of the eviction list of the engine, which holds the ready sounds without channels that aren't pinned.
+        TypeId m_EvictablePrevious = NullId;
+        TypeId m_EvictableNext = NullId;
+        bool m_IsEvictable = false;
+    };
+
+    // The channel state machine and the virtualization, on top of the backend selected at configure time (AudioBackend).
+	class AudioEngine
+	{
+    private:
+        std::filesystem::path ConfigPath;
+        EngineConfig Config;
+	public:
+		AudioEngine(const std::filesystem::path& configPath, const MemorySetup& memory = {});
+		~AudioEngine();
+
+        // Tick the engine on the caller thread, does nothing when the engine has its own thread.
+        // The frame time is ignored, see Voxaudio::Update.
+		void Update(float deltaTimeSecond);
+
+        // Thread safe functions, used by the Voxaudio API.
+        TypeId AcquireSoundId() { return Sounds.AcquireHandle(); }
+        TypeId AcquireChannelId() { return Channels.AcquireHandle(); }
+        // Return the cached sound of the definition with a reference that the channel playing it releases.
+        TypeId AcquireOneShotSound(const SoundDefinition& definition);
+        void ReleaseOneShotSound(TypeId soundId) { m_OneShotSounds.Release(soundId); }
+        // The definition of a RegisterSound command, deleted by the engine once executed.
+        SoundDefinition* NewSoundDefinition(const SoundDefinition& definition) { return m_SoundDefinitions.New(definition); }
+        // The channels of a bulk command, deleted by the engine once executed.
+        ChannelBatch* NewChannelBatch() { return m_ChannelBatches.New(); }
+        void Submit(const EngineCommand& command) { m_Commands.Push(command); }
+        void Submit(std::span<const EngineCommand> commands) { m_Commands.Push(commands); }
+        // Read the state published by the last tick.
+        bool IsPlaying(TypeId channelId) const;
+        EngineStats GetStats() const;
+        // Asked to the backend directly, the clock published by the tick would be late by a frame.
+        uint64_t GetDspClock() const { return m_Backend->GetDspClock(); }
+        int GetSampleRate() const { return m_SampleRate; }
+    public:
+        // Engine thread only.
+        void LoadSound(TypeId soundId, LoadPriority priority = LoadPriority::Prefetch);
+        void UnloadSound(TypeId soundId);
+
+        bool SoundIsLoaded(TypeId soundId) const;
+
+        void PlaySound(TypeId channelId, TypeId soundId, const Vector3& position, float volumedB, bool hasCacheReference = false, uint64_t startClock = 0, std::chrono::steady_clock::time_point requestTime = {});
+        void StopChannel(TypeId channelId, float fadeTimeSeconds, FadeShape fadeShape = FadeShape::LinearDecibel);
+        void StopAllChannels();
+        void SetChannel3dPosition(TypeId channelId, const Vector3& position);
+        void SetChannelVolume(TypeId channelId, float volumedB);
+    public:
+        typedef SlotMap<Sound> SoundMap;
+
+        SoundMap Sounds;
+        ChannelStore Channels;
+    private:
+        void Tick();
+        void ThreadMain();
+        void ReserveFrameBuffers();
+        void PublishMemoryStats();
+        void ExecuteCommand(EngineCommand& command);
+        // SetChannel3dPosition of a channel already resolved.
+        void SetChannel3dPosition(uint32_t channel, TypeId channelId, const Vector3& position);
+        // Resolve the channels of a batch and call write(channel, i) for the ones still alive.
+        // The dense index of the next channel is found, and its data prefetched, before the current one is written.
+        template<typename Prefetch, typename Write>
+        void ForEachBatchChannel(const ChannelBatch& batch, Prefetch&& prefetch, Write&& write);
+        // Publish what the other threads can read (IsPlaying) at the end of a tick.
+        void PublishChannelStates();
+        void RemoveStoppedChannels();
+        // Start up to maxLoadsPerUpdate queued loads, most urgent first.
+        void IssueLoads();
+        bool StartLoad(TypeId soundId, LoadPriority priority);
+        // Check the open state of the sounds being loaded and wake up the channels waiting for them.
+        void PollLoads();
+        void WakeWaitingChannels(Sound& sound, ChannelState state);
+        // Unload the least recently used sounds without channels until the resident memory fits in the budget.
+        void EnforceSampleMemoryBudget();
+        // Put the sound at the most recently used end of the eviction list if it can be evicted, remove it otherwise.
+        void UpdateEvictable(TypeId soundId, Sound& sound);
+        void UnlinkEvictable(Sound& sound);
+        // The entry of the last mounted pack having this name, empty if none has it.
+        std::span<const std::byte> FindPackEntry(std::string_view name) const;
+        void EvictOneShotSound(TypeId soundId);
+        // Dormant channels are only looked at when they are in a cell close to the listener or when they moved.
+        void WakeDormantChannels();
+        void SleepVirtualChannels();
+        uint32_t WakeChannel(uint32_t channel);
+        // Upper bound of the max distance of the dormant channels, from the highest non empty distance class.
+        float ComputeDormantQueryRadius() const;
+        static uint32_t DormantDistanceClass(float maxDistanceSq);
+        // Each pass runs linearly over the channels that were in the matching state at the start of the frame.
+        void BucketChannelsByState();
+        // Fill m_VirtualMask with the distance test and the real voice budget.
+        void ComputeVirtualMask();
+        void ApplyRealVoiceBudget();
+        float ComputeRolloffGain(uint32_t channel) const;
+        float ComputeAudibility(uint32_t channel, float rolloffdB) const;
+        void UpdateStartingChannels();
+        void UpdatePlayingChannels();
+        void UpdateStoppingChannels();
+        void UpdateVirtualizingChannels();
+        void UpdateVirtualChannels();
+
+        // Start a fade of a channel and give its curve to the backend, the update only tracks when it ends.
+        void StartFade(uint32_t channel, FadeTable& fades, float fromVolumedB, float toVolumedB, float fadeTimeSeconds, FadeShape shape);
+        void StartFade(uint32_t channel, FadeTable& fades, float toVolumedB, float fadeTimeSeconds, FadeShape shape);
+        // Replace the fade points of the voice by the remaining curves of its fades.
+        void ScheduleFadePoints(uint32_t channel);
+        // Push the dirty parameters of every active channel to the backend, once at the end of the update.
+        void PushChannelParameters();
+        bool ShouldBeVirtual(uint32_t channel, bool allowVirtualOneShot) const;
+        bool IsChannelPlaying(uint32_t channel);
+        void StopVoice(uint32_t channel);
+    private:
+        // Reserved for the channel capacity at startup, the update never allocates.
+        std::array<std::vector<uint32_t>, static_cast<size_t>(ChannelState::Count)> m_StateBuckets;
+        std::vector<TypeId> m_StoppedChannels;
+        enum VirtualReason : uint8_t
+        {
+            OutOfRange = 1 << 0,
+            OverBudget = 1 << 1,
+        };
+        // One byte per active channel, a combination of VirtualReason, 0 when the channel should be real.
+        std::vector<uint8_t> m_VirtualMask;
+        std::vector<uint32_t> m_VoiceCandidates;
+        // Voices held in the backend, the channels fading out keep theirs so it can exceed the real voice budget.
+        uint32_t m_VoiceCount = 0;
+        std::vector<float> m_Audibilities;
+        // One per voice candidate, the rolloff gain then its dB.
+        std::vector<float> m_RolloffGains;
+        // The active channels with a voice whose volume changed, their VolumesdB and its linear gain.
+        std::vector<uint32_t> m_DirtyVolumeChannels;
+        std::vector<float> m_DirtyVolumesdB;
+        std::vector<float> m_ChannelGains;
+        // Set by the SetListener commands, so the passes never ask the backend for the listener.
+        Vector3 m_ListenerPosition = {0, 0, 0};
+
+        // Accumulated until the end of the next update, then copied in m_LastFrameStats.
+        EngineStats m_PendingStats;
+        EngineStats m_LastFrameStats;
+        mutable std::mutex m_StatsMutex;
+
+        CommandQueue m_Commands;
+        FixedPool<SoundDefinition> m_SoundDefinitions;
+        FixedPool<ChannelBatch> m_ChannelBatches;
+        uint64_t m_SoundsPeak = 0;
+        uint64_t m_ChannelsPeak = 0;
+        SoundCache m_OneShotSounds;
+        LoadScheduler m_LoadScheduler;
+        std::vector<TypeId> m_LoadingSounds;
+        uint64_t m_ResidentSampleBytes = 0;
+        int m_SampleRate = 48000;
+        // Mixer clock, in samples, read at the start of the tick. The fade points are scheduled from it.
+        uint64_t m_DspClock = 0;
+        // Ends of the eviction list, linked through the sounds. The eviction pops the least recently used end.
+        TypeId m_MostRecentEvictable = NullId;
+        TypeId m_LeastRecentEvictable = NullId;
+        // The sounds point in the pack memory, the packs stay mounted until the backend is destroyed.
+        std::vector<std::unique_ptr<SoundPack>> m_SoundPacks;
+        // Created once the config is read, declared after the packs so it is destroyed first.
+        std::optional<AudioBackend> m_Backend;
+        // Indexed by the slot index of the channel id, hold the id when the channel is playing, NullId otherwise.
+        std::unique_ptr<std::atomic<TypeId>[]> m_PlayingChannels;
+        uint32_t m_PlayingChannelsCapacity = 0;
+
+        std::thread m_Thread;
+        std::atomic<bool> m_ThreadRunning = false;
+
+        SpatialHashGrid m_DormantGrid;
+        // Dormant channels counted by power of two of their max distance, so the query radius shrinks when the far ones wake up.
+        // The class k holds the max distances in [2^(k-1), 2^k), the last one everything above.
+        static constexpr size_t DormantDistanceClassCount = 40;
+        std::array<uint32_t, DormantDistanceClassCount> m_DormantDistanceClasses{};
+        std::vector<TypeId> m_MovedDormantChannels;
+        std::vector<TypeId> m_WakingChannels;
+        std::vector<TypeId> m_SleepingChannels;
+    private:
+        void ReadConfigFile();
+        void WriteConfigFile();
+	};
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+#if (_MSC_VER && !__INTEL_COMPILER) || (__MINGW32__ || __MINGW64__)
+    #define VXM_BREAK __debugbreak()
+#elif _POSIX
+    #define VXM_BREAK std::raise(SIGTRAP)
+#else
+    #define VXM_BREAK
+#endif
+
+#define Concat(a,b) a##b
+#define Combine(a,b) Concat(a,b)
+
+namespace Voxymore::Audio
+{
+    // Where a sound created by the backend is, asked by the update until it isn't Loading anymore.
+    enum class BackendLoadState : uint8_t {Loading, Ready, Error};
+
+    // A point of the volume envelope of a voice: the gain reached at this mixer clock, ramped linearly from the previous point.
+    struct FadePoint
+    {
+        uint64_t Clock;
+        float Gain;
+    };
+}
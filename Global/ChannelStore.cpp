@@ -0,0 +1,100 @@
+#include "ChannelStore.hpp"
+#include <utility>
+
+namespace Voxymore::Audio
+{
+    bool ChannelStore::Add(TypeId channelId, TypeId soundId, const SoundDefinition& definition, const Vector3& position, float volumedB, uint8_t flags, uint64_t startClock, std::chrono::steady_clock::time_point requestTime)
+    {
+        if(!m_Table.Insert(channelId)) return false;
+
+        Voices.push_back({});
+        SoundIds.push_back(soundId);
+        PositionsX.push_back(position.x);
+        PositionsY.push_back(position.y);
+        PositionsZ.push_back(position.z);
+        MinDistances.push_back(definition.minDistance);
+        MaxDistancesSq.push_back(definition.maxDistance * definition.maxDistance);
+        Priorities.push_back(definition.priority);
+        VolumesdB.push_back(volumedB);
+        StartClocks.push_back(startClock);
+        RequestTimes.push_back(requestTime);
+        States.push_back(ChannelState::Initialize);
+        Flags.push_back(flags);
+        StopFades.PushBack();
+        VirtualizeFades.PushBack();
+
+        // Appended after the dormant channels, bring it back in the active partition.
+        Wake(static_cast<uint32_t>(Size() - 1));
+        return true;
+    }
+
+    bool ChannelStore::Remove(TypeId channelId)
+    {
+        uint32_t index = m_Table.Find(channelId);
+        if(index == SlotTable::InvalidIndex)
+        {
+            m_Table.Erase(channelId);
+            return false;
+        }
+
+        // Move it to the dormant partition first, that way the swap below never pulls a dormant channel in the active ones.
+        if(index < ActiveCount)
+        {
+            index = Sleep(index);
+        }
+
+        m_Table.Erase(channelId);
+        // Same swap as the one done by the slot table, applied to every array.
+        ForEachArray([index](auto& array)
+        {
+            if(index != array.size() - 1)
+            {
+                array[index] = array.back();
+            }
+            array.pop_back();
+        });
+        return true;
+    }
+
+    void ChannelStore::SetCapacity(uint32_t capacity)
+    {
+        m_Table.SetCapacity(capacity);
+        ForEachArray([capacity](auto& array)
+        {
+            array.reserve(capacity);
+        });
+    }
+
+    uint32_t ChannelStore::Wake(uint32_t index)
+    {
+        if(index < ActiveCount) return index;
+        uint32_t newIndex = ActiveCount++;
+        Swap(index, newIndex);
+        return newIndex;
+    }
+
+    uint32_t ChannelStore::Sleep(uint32_t index)
+    {
+        if(index >= ActiveCount) return index;
+        uint32_t newIndex = --ActiveCount;
+        Swap(index, newIndex);
+        return newIndex;
+    }
+
+    void ChannelStore::Swap(uint32_t a, uint32_t b)
+    {
+        if(a == b) return;
+        m_Table.Swap(a, b);
+        ForEachArray([a, b](auto& array)
+        {
+            std::swap(array[a], array[b]);
+        });
+    }
+
+    void ChannelStore::SetPosition(uint32_t index, const Vector3& position)
+    {
+        PositionsX[index] = position.x;
+        PositionsY[index] = position.y;
+        PositionsZ[index] = position.z;
+    }
+}
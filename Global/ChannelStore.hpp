@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include "SlotMap.hpp"
+#include "FadeTable.hpp"
+#include "AudioBackend.hpp"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    enum class ChannelState : uint8_t
+    {Initialize, ToPlay, Loading, Playing, Stopping, Stopped, Virtualizing, Virtual, Devirtualize, Count};
+
+    // Structure of arrays holding every channel.
+    // All the arrays are parallel and indexed by the dense index of the channel given by Find.
+    // The channels are partitioned: [0, ActiveCount) are updated every frame,
+    // [ActiveCount, Size()) are dormant virtual channels only woken up by the spatial index.
+    // Add, Remove, Wake and Sleep move channels around, so dense indices are only stable until the next one of them.
+    struct ChannelStore
+    {
+        enum Flag : uint8_t
+        {
+            None = 0,
+            StopRequested = 1 << 0,
+            OneShot = 1 << 1,
+            // Dormant channel moved since the last update.
+            Moved = 1 << 2,
+            // Values that changed since they were last pushed to the voice.
+            PositionDirty = 1 << 3,
+            VolumeDirty = 1 << 4,
+            PendingUnpause = 1 << 5,
+            ParametersDirty = PositionDirty | VolumeDirty | PendingUnpause,
+        };
+
+        // The backend voice of the real channels, none for the others.
+        std::vector<AudioBackend::VoiceHandle> Voices;
+        std::vector<TypeId> SoundIds;
+        std::vector<float> PositionsX;
+        std::vector<float> PositionsY;
+        std::vector<float> PositionsZ;
+        std::vector<float> MinDistances;
+        std::vector<float> MaxDistancesSq;
+        std::vector<float> Priorities;
+        std::vector<float> VolumesdB;
+        // Mixer clock the channel starts at, 0 to start as soon as possible.
+        std::vector<uint64_t> StartClocks;
+        // When PlaySound was called, to measure how long the channel took to reach the mixer.
+        std::vector<std::chrono::steady_clock::time_point> RequestTimes;
+        std::vector<ChannelState> States;
+        std::vector<uint8_t> Flags;
+        FadeTable StopFades;
+        FadeTable VirtualizeFades;
+        uint32_t ActiveCount = 0;
+
+        // Thread safe, see SlotTable::AcquireHandle.
+        TypeId AcquireHandle() { return m_Table.AcquireHandle(); }
+        // Create the channel of an acquired handle. New channels are always active.
+        bool Add(TypeId channelId, TypeId soundId, const SoundDefinition& definition, const Vector3& position, float volumedB, uint8_t flags, uint64_t startClock = 0, std::chrono::steady_clock::time_point requestTime = {});
+        // Also release an acquired handle that was never added.
+        bool Remove(TypeId channelId);
+        void SetCapacity(uint32_t capacity);
+        uint32_t GetCapacity() const { return m_Table.GetCapacity(); }
+
+        // Move a channel between the two partitions, return its new dense index.
+        uint32_t Wake(uint32_t index);
+        uint32_t Sleep(uint32_t index);
+        bool IsDormant(uint32_t index) const { return index >= ActiveCount; }
+
+        // Return SlotTable::InvalidIndex if the channel doesn't exist anymore.
+        uint32_t Find(TypeId channelId) const { return m_Table.Find(channelId); }
+        TypeId HandleAt(uint32_t index) const { return m_Table.HandleAt(index); }
+        size_t Size() const { return States.size(); }
+
+        Vector3 GetPosition(uint32_t index) const { return {PositionsX[index], PositionsY[index], PositionsZ[index]}; }
+        void SetPosition(uint32_t index, const Vector3& position);
+        bool HasFlag(uint32_t index, Flag flag) const { return (Flags[index] & flag) != 0; }
+    private:
+        void Swap(uint32_t a, uint32_t b);
+
+        template<typename Func>
+        void ForEachArray(Func&& func)
+        {
+            func(Voices);
+            func(SoundIds);
+            func(PositionsX);
+            func(PositionsY);
+            func(PositionsZ);
+            func(MinDistances);
+            func(MaxDistancesSq);
+            func(Priorities);
+            func(VolumesdB);
+            func(StartClocks);
+            func(RequestTimes);
+            func(States);
+            func(Flags);
+            StopFades.ForEachColumn(func);
+            VirtualizeFades.ForEachColumn(func);
+        }
+    private:
+        SlotTable m_Table;
+    };
+}
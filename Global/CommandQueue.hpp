@@ -0,0 +1,153 @@
+#pragma once
+
+#include "EngineCommand.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    // Commands pushed by any thread, drained by the thread running the engine update.
+    //
+    // The fast path is a bounded multi-producer single-consumer ring (each cell carries a sequence number,
+    // a producer claims a cell with a compare exchange on the tail and publishes it by bumping the sequence).
+    // When the ring is full the commands go to a mutex protected overflow buffer instead of blocking the producer,
+    // the engine may well be the thread that is producing. To keep the order of the commands of each producer,
+    // once a producer hit the overflow every producer keeps using it until the consumer emptied the ring and took the overflow.
+    class CommandQueue
+    {
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> Sequence;
+            EngineCommand Command;
+        };
+    public:
+        // Must be called before any push, the capacity is rounded up to a power of two.
+        void Reserve(size_t capacity)
+        {
+            m_Capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+            m_Mask = m_Capacity - 1;
+            m_Cells = std::make_unique<Cell[]>(m_Capacity);
+            for (size_t i = 0; i < m_Capacity; ++i)
+            {
+                m_Cells[i].Sequence.store(i, std::memory_order_relaxed);
+            }
+            m_Tail.store(0, std::memory_order_relaxed);
+            m_Head = 0;
+
+            std::lock_guard<std::mutex> lock(m_OverflowMutex);
+            m_Overflow.reserve(m_Capacity);
+            m_Draining.reserve(m_Capacity);
+        }
+
+        void Push(const EngineCommand& command)
+        {
+            Push(std::span<const EngineCommand>(&command, 1));
+        }
+
+        // Push a batch of commands, claiming as many ring cells as possible with a single exchange.
+        void Push(std::span<const EngineCommand> commands)
+        {
+            size_t pushed = 0;
+            if(!m_Overflowing.load(std::memory_order_acquire))
+            {
+                pushed = TryPushRing(commands);
+                if(pushed == commands.size()) return;
+            }
+
+            std::lock_guard<std::mutex> lock(m_OverflowMutex);
+            // The consumer may have taken the overflow in between, go back to the ring in that case.
+            if(!m_Overflowing.load(std::memory_order_relaxed))
+            {
+                pushed += TryPushRing(commands.subspan(pushed));
+                if(pushed == commands.size()) return;
+            }
+            m_Overflowing.store(true, std::memory_order_release);
+            m_Overflow.insert(m_Overflow.end(), commands.begin() + static_cast<std::ptrdiff_t>(pushed), commands.end());
+        }
+
+        // Consumer thread only. Call func(EngineCommand&) on every command, in the order each producer pushed them.
+        template<typename Func>
+        void Drain(Func&& func)
+        {
+            while (true)
+            {
+                Cell& cell = m_Cells[m_Head & m_Mask];
+                if(cell.Sequence.load(std::memory_order_acquire) != m_Head + 1) break;
+
+                func(cell.Command);
+                cell.Sequence.store(m_Head + m_Capacity, std::memory_order_release);
+                ++m_Head;
+            }
+
+            if(!m_Overflowing.load(std::memory_order_acquire)) return;
+            // A producer is still writing a cell claimed before the overflow started, its command must come first.
+            if(m_Tail.load(std::memory_order_acquire) != m_Head) return;
+            {
+                std::lock_guard<std::mutex> lock(m_OverflowMutex);
+                std::swap(m_Overflow, m_Draining);
+                m_Overflowing.store(false, std::memory_order_release);
+            }
+
+            for (EngineCommand& command : m_Draining)
+            {
+                func(command);
+            }
+            m_Draining.clear();
+        }
+    private:
+        // Return the number of commands pushed, less than the count only when the ring is full.
+        size_t TryPushRing(std::span<const EngineCommand> commands)
+        {
+            size_t pushed = 0;
+            size_t tail = m_Tail.load(std::memory_order_relaxed);
+            while (pushed < commands.size())
+            {
+                // The consumer frees the cells in order, so if the last cell of the range is free the whole range is.
+                size_t count = std::min(commands.size() - pushed, m_Capacity);
+                if(m_Cells[(tail + count - 1) & m_Mask].Sequence.load(std::memory_order_acquire) != tail + count - 1)
+                {
+                    size_t sequence = m_Cells[tail & m_Mask].Sequence.load(std::memory_order_acquire);
+                    // The consumer hasn't freed this cell yet, the ring is full.
+                    if(sequence < tail) return pushed;
+                    if(sequence != tail)
+                    {
+                        tail = m_Tail.load(std::memory_order_relaxed);
+                        continue;
+                    }
+                    count = 1;
+                }
+
+                if(!m_Tail.compare_exchange_weak(tail, tail + count, std::memory_order_relaxed)) continue;
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    Cell& cell = m_Cells[(tail + i) & m_Mask];
+                    cell.Command = commands[pushed + i];
+                    cell.Sequence.store(tail + i + 1, std::memory_order_release);
+                }
+                pushed += count;
+                tail += count;
+            }
+            return pushed;
+        }
+    private:
+        std::unique_ptr<Cell[]> m_Cells;
+        size_t m_Capacity = 0;
+        size_t m_Mask = 0;
+        // Separate cache lines: the producers hammer the tail, the consumer owns the head.
+        alignas(64) std::atomic<size_t> m_Tail = 0;
+        alignas(64) size_t m_Head = 0;
+
+        std::atomic<bool> m_Overflowing = false;
+        std::mutex m_OverflowMutex;
+        std::vector<EngineCommand> m_Overflow;
+        std::vector<EngineCommand> m_Draining;
+    };
+}
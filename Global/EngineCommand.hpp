@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    class SoundPack;
+
+    enum class CommandType : uint8_t
+    {
+        RegisterSound,
+        RegisterSounds,
+        MountSoundPack,
+        UnregisterSound,
+        LoadSound,
+        UnloadSound,
+        SetListener,
+        PlaySound,
+        StopChannel,
+        StopAllChannels,
+        SetChannelPosition,
+        SetChannelVolume,
+        // Bulk versions of the channel commands, each one carries a ChannelBatch.
+        PlaySounds,
+        StopChannels,
+        SetChannelPositions,
+        SetChannelVolumes,
+    };
+
+    // The sounds of a bulk registration, Ids[i] is the id acquired for Definitions[i].
+    struct SoundRegistrationBatch
+    {
+        std::vector<TypeId> Ids;
+        std::vector<SoundDefinition> Definitions;
+    };
+
+    // Up to Capacity channels of a bulk call, copied from the caller spans so the command stays small.
+    // Only the arrays used by the command type are filled: Ids always, SoundIds by PlaySounds,
+    // Positions by PlaySounds and SetChannelPositions, Values (volumes in dB) by PlaySounds and SetChannelVolumes.
+    struct ChannelBatch
+    {
+        static constexpr uint32_t Capacity = 64;
+
+        uint32_t Count = 0;
+        std::array<TypeId, Capacity> Ids;
+        std::array<TypeId, Capacity> SoundIds;
+        std::array<Vector3, Capacity> Positions;
+        std::array<float, Capacity> Values;
+    };
+
+    // Every mutation done through the Voxaudio API is recorded as a command and executed by the engine update.
+    struct EngineCommand
+    {
+        enum Flag : uint8_t
+        {
+            None = 0,
+            Load = 1 << 0,
+            HasVelocity = 1 << 1,
+            // PlaySound of a one shot, the command carries the sound cache reference taken by PlayOnShot.
+            OneShot = 1 << 2,
+        };
+
+        CommandType Type;
+        uint8_t Flags = None;
+        // The sound or the channel targeted by the command.
+        TypeId Id = NullId;
+        // The sound played by PlaySound.
+        TypeId SoundId = NullId;
+        // PlaySound only, the mixer clock the sound starts at, 0 to start as soon as possible.
+        uint64_t StartClock = 0;
+        // PlaySound only, when the Voxaudio call was made, to measure the start latency.
+        std::chrono::steady_clock::time_point RequestTime = {};
+        // Volume in dB or fade time in seconds.
+        float Value = 0.0f;
+        // LoadSound and RegisterSound with the Load flag.
+        LoadPriority Priority = LoadPriority::Prefetch;
+        // StopChannel only.
+        FadeShape Shape = FadeShape::LinearDecibel;
+        Vector3 Position = {0, 0, 0};
+        Vector3 Look = {0, 0, 0};
+        Vector3 Up = {0, 0, 0};
+        Vector3 Velocity = {0, 0, 0};
+        // RegisterSound only, allocated by the caller and deleted once the command is executed.
+        SoundDefinition* Definition = nullptr;
+        // RegisterSounds only, same ownership as Definition.
+        SoundRegistrationBatch* Batch = nullptr;
+        // The bulk channel commands, allocated from the pool of the engine and deleted once the command is executed.
+        ChannelBatch* Channels = nullptr;
+        // MountSoundPack only, opened by the caller, owned by the engine once executed.
+        SoundPack* Pack = nullptr;
+    };
+}
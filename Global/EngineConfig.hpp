@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    enum class OutputMode : uint8_t
+    {
+        // The sound card, mixed by the backend's own thread.
+        RealTime,
+        // Non real time: nothing is output, each Voxaudio::Update mixes exactly one DSP buffer (dspBufferLength samples)
+        // as fast as the CPU allows. The loads are blocking and the streams decoded by the update, so runs are reproducible.
+        NoSoundNrt,
+        // Same as NoSoundNrt, the mix is written to wavWriterPath.
+        WavWriterNrt,
+    };
+
+    enum class SpeakerMode : uint8_t
+    {
+        Default,
+        // FMOD only, the channels of the sounds are output as they are.
+        Raw,
+        Mono,
+        Stereo,
+        Quad,
+        Surround,
+        FivePointOne,
+        SevenPointOne,
+        SevenPointOnePointFour,
+    };
+
+    // Read from the section of the backend in the config file (AudioBackend::ConfigSection).
+    struct EngineConfig
+    {
+        int numberOfChannels = 128;
+        // Maximum number of channels allowed to be real at the same time, the least audible ones are virtualized.
+        // 0 use numberOfChannels.
+        int realVoiceBudget = 0;
+        // Size of the cells of the spatial index holding the dormant virtual channels.
+        float spatialCellSize = 32.0f;
+        // Capacity of the id tables, ids are given by the caller thread so the tables can't grow.
+        int maxChannels = 65536;
+        int maxSounds = 32768;
+        // When true the engine owns a thread ticking at engineTickRate (Hz) and Voxaudio::Update does nothing.
+        bool useEngineThread = false;
+        float engineTickRate = 60.0f;
+        // Commands that fit in the lock-free ring, the extra ones spill in a slower locked buffer.
+        int commandQueueCapacity = 8192;
+        // One shot sounds kept loaded once no channel uses them anymore, the least recently played are evicted first.
+        int oneShotCacheCapacity = 256;
+        // Loads started per update, the other ones wait in the scheduler.
+        int maxLoadsPerUpdate = 4;
+        // Memory allowed for the loaded sound data, in bytes. Sounds without channels are unloaded (least recently used first)
+        // when it is exceeded, and reloaded when played again. 0 means no budget.
+        uint64_t sampleMemoryBudget = 0;
+        // Packs mounted at startup, a sound whose name is an entry of a pack is loaded from the pack memory.
+        std::vector<std::string> soundPacks;
+        // FMOD only, read the sound files through the engine I/O scheduler (streams first) instead of the FMOD file thread.
+        bool useAsyncFileSystem = true;
+        int ioThreads = 2;
+        // FMOD only, size of a block allocated at startup that FMOD allocates from, rounded down to 512 bytes.
+        // 0 lets FMOD use its own heap. Ignored when a memory setup is given to Voxaudio::Init.
+        uint32_t fmodMemoryPoolSize = 0;
+        // Sound definitions waiting in the command queue, the extra ones are allocated on the heap.
+        int soundDefinitionPoolCapacity = 1024;
+        // Batches of 64 channels of the bulk functions (PlaySounds, SetChannel3dPositions...) waiting in the command queue.
+        int channelBatchPoolCapacity = 64;
+
+        // Output format, 0 keeps the backend default of each value.
+        // The mixer output holds dspBufferLength * dspBufferCount samples, the main part of the output latency.
+        uint32_t dspBufferLength = 0;
+        int dspBufferCount = 0;
+        int sampleRate = 0;
+        // FMOD only, voices FMOD really mixes, the other real channels are virtualized by FMOD itself.
+        int softwareChannels = 0;
+        SpeakerMode speakerMode = SpeakerMode::Default;
+        // FMOD only, codecs allocated at init for the compressed samples played at the same time, 0 keeps the FMOD default.
+        int maxMpegCodecs = 0;
+        int maxAdpcmCodecs = 0;
+        int maxXmaCodecs = 0;
+        int maxVorbisCodecs = 0;
+        int maxAt9Codecs = 0;
+        int maxFadpcmCodecs = 0;
+        int maxOpusCodecs = 0;
+
+        // The non real time modes are meant for Voxaudio::Update, the engine thread would tick them at engineTickRate.
+        OutputMode outputMode = OutputMode::RealTime;
+        std::string wavWriterPath = "VoxaudioOutput.wav";
+
+        bool IsNonRealTime() const { return outputMode != OutputMode::RealTime; }
+    };
+}
@@ -0,0 +1,103 @@
+#include "FadeTable.hpp"
+#include "SimdMath.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Voxymore::Audio
+{
+    void FadeTable::PushBack()
+    {
+        From.push_back(0.0f);
+        To.push_back(0.0f);
+        Elapsed.push_back(0.0f);
+        Duration.push_back(0.0f);
+        Shapes.push_back(static_cast<float>(FadeShape::LinearDecibel));
+        Gains.push_back(1.0f);
+    }
+
+    void FadeTable::Start(uint32_t index, float fromVolumedB, float toVolumedB, float fadeTimeSeconds, FadeShape shape)
+    {
+        if(shape == FadeShape::LinearDecibel)
+        {
+            From[index] = fromVolumedB;
+            To[index] = toVolumedB;
+        }
+        else
+        {
+            From[index] = Helper::dBToVolume(fromVolumedB);
+            To[index] = Helper::dBToVolume(toVolumedB);
+        }
+
+        // A fade of 0 seconds is already at its destination, it starts there so the kernel never divides by 0.
+        if(fadeTimeSeconds <= 0.0f)
+        {
+            From[index] = To[index];
+            fadeTimeSeconds = 0.0f;
+        }
+        Elapsed[index] = 0.0f;
+        Duration[index] = fadeTimeSeconds;
+        Shapes[index] = static_cast<float>(shape);
+        Gains[index] = shape == FadeShape::LinearDecibel ? Helper::dBToVolume(From[index]) : From[index];
+    }
+
+    void FadeTable::Start(uint32_t index, float toVolumedB, float fadeTimeSeconds, FadeShape shape)
+    {
+        // The silence of the faders is far above the smallest float, the clamp only avoids -inf.
+        float currentVolumedB = Helper::VolumeTodB(std::max(Gains[index], 1e-10f));
+        Start(index, currentVolumedB, toVolumedB, fadeTimeSeconds, shape);
+    }
+
+    // Gain of the fades at the elapsed time e.
+    template<typename V>
+    static inline V EvaluateLanes(const float* from, const float* to, V e, V d, const float* shapes)
+    {
+        // Finished fades and fades of 0 seconds are at t = 1.
+        V t = Select(Less(e, d), e / Max(d, V::Set(1e-6f)), V::Set(1.0f));
+        V one = V::Set(1.0f);
+
+        // value = wFrom * from + wTo * to, the weights depend on the shape.
+        V shape = V::Load(shapes);
+        V isDecibel = Less(shape, V::Set(0.5f));
+        V isEqualPower = Less(shape, V::Set(1.5f));
+        V smooth = t * t * (V::Set(3.0f) - V::Set(2.0f) * t);
+        V wTo = Select(isDecibel, t, Select(isEqualPower, SinHalfPi(t), smooth));
+        V wFrom = Select(isDecibel, one - t, Select(isEqualPower, SinHalfPi(one - t), one - smooth));
+        V value = MulAdd(wFrom, V::Load(from), wTo * V::Load(to));
+
+        return Select(isDecibel, DecibelToGain(value), value);
+    }
+
+    template<typename V>
+    static inline void AdvanceLanes(const float* from, const float* to, float* elapsed, const float* duration, const float* shapes, float* gains, V deltaTime)
+    {
+        V e = V::Load(elapsed);
+        V d = V::Load(duration);
+        e = Select(Less(e, d), Min(e + deltaTime, d), e);
+        e.Store(elapsed);
+        EvaluateLanes(from, to, e, d, shapes).Store(gains);
+    }
+
+    float FadeTable::GainAfter(uint32_t index, float seconds) const
+    {
+        using Simd::FloatScalar;
+        FloatScalar d = FloatScalar::Set(Duration[index]);
+        FloatScalar e = Min(FloatScalar::Set(Elapsed[index] + seconds), d);
+        return EvaluateLanes(From.data() + index, To.data() + index, e, d, Shapes.data() + index).v;
+    }
+
+    void FadeTable::Advance(size_t count, float deltaTimeSeconds)
+    {
+        size_t i = 0;
+        const Simd::FloatV deltaTime = Simd::FloatV::Set(deltaTimeSeconds);
+        for (; i + Simd::FloatV::Width <= count; i += Simd::FloatV::Width)
+        {
+            AdvanceLanes(From.data() + i, To.data() + i, Elapsed.data() + i, Duration.data() + i, Shapes.data() + i, Gains.data() + i, deltaTime);
+        }
+
+        const Simd::FloatScalar scalarDeltaTime = Simd::FloatScalar::Set(deltaTimeSeconds);
+        for (; i < count; ++i)
+        {
+            AdvanceLanes(From.data() + i, To.data() + i, Elapsed.data() + i, Duration.data() + i, Shapes.data() + i, Gains.data() + i, scalarDeltaTime);
+        }
+    }
+}
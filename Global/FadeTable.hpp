@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    // Structure of arrays holding one fade per entry, the owner keeps it parallel to its own arrays.
+    // Every fade is advanced at once by a vectorized kernel which writes its linear gain,
+    // so no per-fade code (nor pow) runs in the update.
+    // GainAfter samples the curve ahead of time, for a mixer which ramps the fade itself.
+    struct FadeTable
+    {
+        // In dB for LinearDecibel, in linear gain for the other shapes.
+        std::vector<float> From;
+        std::vector<float> To;
+        std::vector<float> Elapsed;
+        std::vector<float> Duration;
+        // The FadeShape, stored as a float so the kernel compares it without conversion.
+        std::vector<float> Shapes;
+        // Linear gain at Elapsed, written by Start and Advance.
+        std::vector<float> Gains;
+
+        // Append a finished fade at unity gain.
+        void PushBack();
+        void Start(uint32_t index, float fromVolumedB, float toVolumedB, float fadeTimeSeconds, FadeShape shape);
+        // Fade from the current gain of the entry.
+        void Start(uint32_t index, float toVolumedB, float fadeTimeSeconds, FadeShape shape);
+        bool IsFinished(uint32_t index) const { return Elapsed[index] >= Duration[index]; }
+        float GetRemainingTime(uint32_t index) const { return Duration[index] - Elapsed[index]; }
+        // Linear gain the fade will have in seconds, the end gain once past its duration.
+        float GainAfter(uint32_t index, float seconds) const;
+
+        // Advance the fades [0, count) and update their gain.
+        void Advance(size_t count, float deltaTimeSeconds);
+
+        template<typename Func>
+        void ForEachColumn(Func&& func)
+        {
+            func(From);
+            func(To);
+            func(Elapsed);
+            func(Duration);
+            func(Shapes);
+            func(Gains);
+        }
+    };
+}
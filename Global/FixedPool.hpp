@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace Voxymore::Audio
+{
+    // A fixed number of objects allocated once, New and Delete are lock-free and can be called from any thread.
+    // The free blocks form a stack whose head is tagged with a counter, like the slots of the SlotTable.
+    // When the pool is full New falls back to the heap, the overflows are counted so the capacity can be tuned.
+    template<typename T>
+    class FixedPool
+    {
+    private:
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+        struct Block
+        {
+            alignas(T) std::byte Storage[sizeof(T)];
+            std::atomic<uint32_t> NextFree = InvalidIndex;
+        };
+
+        static constexpr uint64_t MakeFreeHead(uint32_t blockIndex, uint32_t tag) { return (static_cast<uint64_t>(tag) << 32) | blockIndex; }
+        static constexpr uint32_t FreeHeadIndex(uint64_t head) { return static_cast<uint32_t>(head); }
+        static constexpr uint32_t FreeHeadTag(uint64_t head) { return static_cast<uint32_t>(head >> 32); }
+    public:
+        // Must be called before any object is allocated.
+        void SetCapacity(uint32_t capacity)
+        {
+            m_Capacity = capacity;
+            m_Blocks = std::make_unique<Block[]>(m_Capacity);
+            m_FreeHead.store(MakeFreeHead(InvalidIndex, 0), std::memory_order_relaxed);
+            m_NextUnused.store(0, std::memory_order_relaxed);
+            m_Used.store(0, std::memory_order_relaxed);
+            m_Peak.store(0, std::memory_order_relaxed);
+            m_Overflows.store(0, std::memory_order_relaxed);
+        }
+
+        template<typename... Args>
+        T* New(Args&&... args)
+        {
+            uint32_t blockIndex = PopFreeBlock();
+            if(blockIndex == InvalidIndex)
+            {
+                uint32_t nextUnused = m_NextUnused.load(std::memory_order_relaxed);
+                do
+                {
+                    if(nextUnused >= m_Capacity)
+                    {
+                        m_Overflows.fetch_add(1, std::memory_order_relaxed);
+                        return new T(std::forward<Args>(args)...);
+                    }
+                } while (!m_NextUnused.compare_exchange_weak(nextUnused, nextUnused + 1, std::memory_order_relaxed));
+                blockIndex = nextUnused;
+            }
+
+            uint32_t used = m_Used.fetch_add(1, std::memory_order_relaxed) + 1;
+            uint32_t peak = m_Peak.load(std::memory_order_relaxed);
+            while (used > peak && !m_Peak.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {}
+
+            return new (m_Blocks[blockIndex].Storage) T(std::forward<Args>(args)...);
+        }
+
+        // Accept the objects that overflowed to the heap as well as nullptr.
+        void Delete(T* object)
+        {
+            if(!object) return;
+
+            // Compared as integers, the order of pointers to different allocations is unspecified.
+            auto address = reinterpret_cast<std::uintptr_t>(object);
+            auto blocksBegin = reinterpret_cast<std::uintptr_t>(m_Blocks.get());
+            auto blocksEnd = reinterpret_cast<std::uintptr_t>(m_Blocks.get() + m_Capacity);
+            if(address < blocksBegin || address >= blocksEnd)
+            {
+                delete object;
+                return;
+            }
+
+            auto* block = reinterpret_cast<Block*>(reinterpret_cast<std::byte*>(object) - offsetof(Block, Storage));
+
+            object->~T();
+            m_Used.fetch_sub(1, std::memory_order_relaxed);
+            uint32_t blockIndex = static_cast<uint32_t>(block - m_Blocks.get());
+
+            uint64_t head = m_FreeHead.load(std::memory_order_relaxed);
+            do
+            {
+                block->NextFree.store(FreeHeadIndex(head), std::memory_order_relaxed);
+            } while (!m_FreeHead.compare_exchange_weak(head, MakeFreeHead(blockIndex, FreeHeadTag(head) + 1), std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        uint32_t GetCapacity() const { return m_Capacity; }
+        uint32_t Used() const { return m_Used.load(std::memory_order_relaxed); }
+        // Highest number of objects alive at the same time in the pool since SetCapacity.
+        uint32_t Peak() const { return m_Peak.load(std::memory_order_relaxed); }
+        // Objects allocated on the heap because the pool was full.
+        uint32_t Overflows() const { return m_Overflows.load(std::memory_order_relaxed); }
+    private:
+        uint32_t PopFreeBlock()
+        {
+            uint64_t head = m_FreeHead.load(std::memory_order_acquire);
+            while (FreeHeadIndex(head) != InvalidIndex)
+            {
+                uint32_t next = m_Blocks[FreeHeadIndex(head)].NextFree.load(std::memory_order_relaxed);
+                if(m_FreeHead.compare_exchange_weak(head, MakeFreeHead(next, FreeHeadTag(head) + 1), std::memory_order_acquire, std::memory_order_acquire))
+                {
+                    return FreeHeadIndex(head);
+                }
+            }
+            return InvalidIndex;
+        }
+    private:
+        std::unique_ptr<Block[]> m_Blocks;
+        uint32_t m_Capacity = 0;
+        std::atomic<uint64_t> m_FreeHead = MakeFreeHead(InvalidIndex, 0);
+        std::atomic<uint32_t> m_NextUnused = 0;
+        std::atomic<uint32_t> m_Used = 0;
+        std::atomic<uint32_t> m_Peak = 0;
+        std::atomic<uint32_t> m_Overflows = 0;
+    };
+}
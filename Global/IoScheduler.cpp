@@ -0,0 +1,189 @@
+#include "IoScheduler.hpp"
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Voxymore::Audio
+{
+    IoFile::~IoFile()
+    {
+        Close();
+    }
+
+#ifdef _WIN32
+    bool IoFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+        HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(handle == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER size;
+        if(!GetFileSizeEx(handle, &size))
+        {
+            CloseHandle(handle);
+            return false;
+        }
+        m_Handle = handle;
+        m_Size = static_cast<uint64_t>(size.QuadPart);
+        return true;
+    }
+
+    void IoFile::Close()
+    {
+        if(m_Handle) CloseHandle(m_Handle);
+        m_Handle = nullptr;
+        m_Size = 0;
+    }
+
+    int64_t IoFile::ReadAt(uint64_t offset, void* buffer, uint32_t size) const
+    {
+        // An offset in the OVERLAPPED structure makes the read positional on a synchronous handle.
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD bytesRead = 0;
+        if(!ReadFile(m_Handle, buffer, size, &bytesRead, &overlapped) && GetLastError() != ERROR_HANDLE_EOF) return -1;
+        return bytesRead;
+    }
+#else
+    bool IoFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+        if(descriptor < 0) return false;
+
+        struct stat status{};
+        if(::fstat(descriptor, &status) != 0)
+        {
+            ::close(descriptor);
+            return false;
+        }
+        m_Descriptor = descriptor;
+        m_Size = static_cast<uint64_t>(status.st_size);
+        return true;
+    }
+
+    void IoFile::Close()
+    {
+        if(m_Descriptor >= 0) ::close(m_Descriptor);
+        m_Descriptor = -1;
+        m_Size = 0;
+    }
+
+    int64_t IoFile::ReadAt(uint64_t offset, void* buffer, uint32_t size) const
+    {
+        uint32_t total = 0;
+        while (total < size)
+        {
+            ssize_t result = ::pread(m_Descriptor, static_cast<char*>(buffer) + total, size - total, static_cast<off_t>(offset + total));
+            if(result < 0) return -1;
+            if(result == 0) break;
+            total += static_cast<uint32_t>(result);
+        }
+        return total;
+    }
+#endif
+
+    IoScheduler::IoScheduler(uint32_t threadCount)
+    {
+        threadCount = std::max(threadCount, 1u);
+        m_Workers.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            m_Workers.emplace_back(&IoScheduler::WorkerMain, this);
+        }
+    }
+
+    IoScheduler::~IoScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Running = false;
+        }
+        m_WorkAvailable.notify_all();
+        for (std::thread& worker : m_Workers) worker.join();
+    }
+
+    void IoScheduler::Submit(const Request& request)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            Request& queued = m_Queues[static_cast<size_t>(request.Priority)].emplace_back(request);
+            queued.Submitted = std::chrono::steady_clock::now();
+        }
+        m_WorkAvailable.notify_one();
+    }
+
+    bool IoScheduler::Cancel(void* user)
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        for (std::deque<Request>& queue : m_Queues)
+        {
+            auto it = std::find_if(queue.begin(), queue.end(), [user](const Request& request) { return request.User == user; });
+            if(it != queue.end())
+            {
+                queue.erase(it);
+                return true;
+            }
+        }
+
+        m_RequestFinished.wait(lock, [this, user]() { return std::find(m_InFlight.begin(), m_InFlight.end(), user) == m_InFlight.end(); });
+        return false;
+    }
+
+    IoStats IoScheduler::ConsumeStats()
+    {
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        IoStats stats = m_Stats;
+        stats.averageLatencyMs = stats.reads > 0 ? static_cast<float>(m_TotalLatencyMs / stats.reads) : 0.0f;
+        m_Stats = {};
+        m_TotalLatencyMs = 0.0;
+        return stats;
+    }
+
+    void IoScheduler::WorkerMain()
+    {
+        while (true)
+        {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                auto hasWork = [this]() { return std::any_of(m_Queues.begin(), m_Queues.end(), [](const auto& queue) { return !queue.empty(); }); };
+                m_WorkAvailable.wait(lock, [&]() { return !m_Running || hasWork(); });
+                if(!m_Running) return;
+
+                std::deque<Request>& queue = *std::find_if(m_Queues.begin(), m_Queues.end(), [](const auto& q) { return !q.empty(); });
+                request = queue.front();
+                queue.pop_front();
+                m_InFlight.push_back(request.User);
+            }
+
+            int64_t bytesRead = request.File->ReadAt(request.Offset, request.Buffer, request.Size);
+            float latencyMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - request.Submitted).count();
+            request.Done(request.User, bytesRead);
+
+            {
+                std::lock_guard<std::mutex> lock(m_StatsMutex);
+                ++m_Stats.reads;
+                m_Stats.bytesRead += bytesRead > 0 ? static_cast<uint64_t>(bytesRead) : 0;
+                m_Stats.maxLatencyMs = std::max(m_Stats.maxLatencyMs, latencyMs);
+                m_TotalLatencyMs += latencyMs;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_InFlight.erase(std::find(m_InFlight.begin(), m_InFlight.end(), request.User));
+            }
+            m_RequestFinished.notify_all();
+        }
+    }
+}
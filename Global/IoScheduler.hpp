@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    // The reads are served in this order, a read of a lower class only starts when no read of a higher class is waiting.
+    enum class IoPriority : uint8_t
+    {
+        // Data of a stream being played, a late read is an audible glitch.
+        Stream,
+        // A channel is waiting for the sound to start.
+        Imminent,
+        Prefetch,
+        Count,
+    };
+
+    // A file opened for positional reads, it can be read by several threads at once.
+    class IoFile
+    {
+    public:
+        IoFile() = default;
+        ~IoFile();
+
+        IoFile(const IoFile&) = delete;
+        IoFile& operator=(const IoFile&) = delete;
+
+        bool Open(const std::filesystem::path& path);
+        void Close();
+
+        uint64_t Size() const { return m_Size; }
+        // Return the number of bytes read, less than size at the end of the file, -1 on error.
+        int64_t ReadAt(uint64_t offset, void* buffer, uint32_t size) const;
+    private:
+#ifdef _WIN32
+        void* m_Handle = nullptr;
+#else
+        int m_Descriptor = -1;
+#endif
+        uint64_t m_Size = 0;
+    };
+
+    struct IoStats
+    {
+        uint32_t reads = 0;
+        uint64_t bytesRead = 0;
+        // From the submission of a read to its completion.
+        float maxLatencyMs = 0.0f;
+        float averageLatencyMs = 0.0f;
+    };
+
+    // Serve the reads with a pool of threads, most urgent class first, in submission order inside a class.
+    // There is no io_uring backend: a few blocking positional reads in flight are enough for the sizes asked by FMOD.
+    class IoScheduler
+    {
+    public:
+        // Called on a worker thread once the read is done, bytesRead is -1 on error.
+        using DoneFunc = void(*)(void* user, int64_t bytesRead);
+
+        struct Request
+        {
+            const IoFile* File = nullptr;
+            uint64_t Offset = 0;
+            void* Buffer = nullptr;
+            uint32_t Size = 0;
+            IoPriority Priority = IoPriority::Prefetch;
+            DoneFunc Done = nullptr;
+            // Identify the request for Cancel, must be unique among the requests in flight.
+            void* User = nullptr;
+            std::chrono::steady_clock::time_point Submitted;
+        };
+    public:
+        explicit IoScheduler(uint32_t threadCount = 2);
+        ~IoScheduler();
+
+        IoScheduler(const IoScheduler&) = delete;
+        IoScheduler& operator=(const IoScheduler&) = delete;
+
+        void Submit(const Request& request);
+        // Once Cancel returns, the request identified by user is not in the queues and its done function is not running.
+        // Return true if the request was still queued (its done function is never called).
+        bool Cancel(void* user);
+
+        // The counters since the previous call.
+        IoStats ConsumeStats();
+    private:
+        void WorkerMain();
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_WorkAvailable;
+        std::condition_variable m_RequestFinished;
+        std::array<std::deque<Request>, static_cast<size_t>(IoPriority::Count)> m_Queues;
+        std::vector<void*> m_InFlight;
+        std::vector<std::thread> m_Workers;
+        bool m_Running = true;
+
+        std::mutex m_StatsMutex;
+        IoStats m_Stats;
+        double m_TotalLatencyMs = 0.0;
+    };
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include <array>
+#include <cstdint>
+#include <deque>
+
+namespace Voxymore::Audio
+{
+    // One FIFO of sound ids per priority class, the most urgent class is always served first.
+    // The scheduler doesn't know the sounds, the owner keeps the queued priority of each sound:
+    // a sound whose priority is raised is pushed again and its old entry is skipped by the issue function.
+    class LoadScheduler
+    {
+    public:
+        void Request(TypeId soundId, LoadPriority priority)
+        {
+            m_Queues[static_cast<size_t>(priority)].push_back(soundId);
+        }
+
+        // Call issue(TypeId, LoadPriority) in priority order until it returned true maxCount times or the queues are empty.
+        // issue returns false for a stale entry, which doesn't count toward maxCount.
+        template<typename Func>
+        uint32_t Issue(uint32_t maxCount, Func&& issue)
+        {
+            uint32_t issued = 0;
+            for (size_t priority = 0; priority < m_Queues.size() && issued < maxCount; ++priority)
+            {
+                std::deque<TypeId>& queue = m_Queues[priority];
+                while (!queue.empty() && issued < maxCount)
+                {
+                    TypeId soundId = queue.front();
+                    queue.pop_front();
+                    if(issue(soundId, static_cast<LoadPriority>(priority))) ++issued;
+                }
+            }
+            return issued;
+        }
+
+        void Clear()
+        {
+            for (auto& queue : m_Queues) queue.clear();
+        }
+
+        size_t Size() const
+        {
+            size_t size = 0;
+            for (const auto& queue : m_Queues) size += queue.size();
+            return size;
+        }
+    private:
+        std::array<std::deque<TypeId>, static_cast<size_t>(LoadPriority::Count)> m_Queues;
+    };
+}
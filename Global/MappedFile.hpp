@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace Voxymore::Audio
+{
+    // Read only memory mapping of a whole file, unmapped on destruction.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        // Return false if the file can't be opened or mapped, an empty file is not mapped.
+        bool Open(const std::filesystem::path& path);
+        void Close();
+
+        bool IsOpen() const { return m_Data != nullptr; }
+        const std::byte* Data() const { return m_Data; }
+        size_t Size() const { return m_Size; }
+        std::span<const std::byte> Bytes() const { return {m_Data, m_Size}; }
+    private:
+        const std::byte* m_Data = nullptr;
+        size_t m_Size = 0;
+#ifdef _WIN32
+        void* m_File = nullptr;
+        void* m_Mapping = nullptr;
+#endif
+    };
+}
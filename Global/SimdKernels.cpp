@@ -0,0 +1,247 @@
+#include "SimdKernels.hpp"
+#include "SimdMath.hpp"
+
+#if VXM_SIMD_AVX2 || VXM_SIMD_SSE2
+    #include <immintrin.h>
+#elif VXM_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace Voxymore::Audio::Simd
+{
+    const char* GetInstructionSet()
+    {
+#if VXM_SIMD_AVX2
+        return "AVX2";
+#elif VXM_SIMD_SSE2
+        return "SSE2";
+#elif VXM_SIMD_NEON
+        return "NEON";
+#else
+        return "Scalar";
+#endif
+    }
+
+    void ComputeOutOfRangeMask(const float* x, const float* y, const float* z, const float* maxDistanceSq, size_t count, const Vector3& listener, uint8_t* outMask)
+    {
+        size_t i = 0;
+#if VXM_SIMD_AVX2
+        const __m256 lx = _mm256_set1_ps(listener.x);
+        const __m256 ly = _mm256_set1_ps(listener.y);
+        const __m256 lz = _mm256_set1_ps(listener.z);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), lx);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), ly);
+            __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), lz);
+            __m256 distanceSq = _mm256_mul_ps(dx, dx);
+            distanceSq = _mm256_add_ps(distanceSq, _mm256_mul_ps(dy, dy));
+            distanceSq = _mm256_add_ps(distanceSq, _mm256_mul_ps(dz, dz));
+            int bits = _mm256_movemask_ps(_mm256_cmp_ps(distanceSq, _mm256_loadu_ps(maxDistanceSq + i), _CMP_GT_OQ));
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                outMask[i + lane] = static_cast<uint8_t>((bits >> lane) & 1);
+            }
+        }
+#elif VXM_SIMD_SSE2
+        const __m128 lx = _mm_set1_ps(listener.x);
+        const __m128 ly = _mm_set1_ps(listener.y);
+        const __m128 lz = _mm_set1_ps(listener.z);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), lx);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), ly);
+            __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), lz);
+            __m128 distanceSq = _mm_mul_ps(dx, dx);
+            distanceSq = _mm_add_ps(distanceSq, _mm_mul_ps(dy, dy));
+            distanceSq = _mm_add_ps(distanceSq, _mm_mul_ps(dz, dz));
+            int bits = _mm_movemask_ps(_mm_cmpgt_ps(distanceSq, _mm_loadu_ps(maxDistanceSq + i)));
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                outMask[i + lane] = static_cast<uint8_t>((bits >> lane) & 1);
+            }
+        }
+#elif VXM_SIMD_NEON
+        const float32x4_t lx = vdupq_n_f32(listener.x);
+        const float32x4_t ly = vdupq_n_f32(listener.y);
+        const float32x4_t lz = vdupq_n_f32(listener.z);
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4_t dx = vsubq_f32(vld1q_f32(x + i), lx);
+            float32x4_t dy = vsubq_f32(vld1q_f32(y + i), ly);
+            float32x4_t dz = vsubq_f32(vld1q_f32(z + i), lz);
+            float32x4_t distanceSq = vmulq_f32(dx, dx);
+            distanceSq = vfmaq_f32(distanceSq, dy, dy);
+            distanceSq = vfmaq_f32(distanceSq, dz, dz);
+            int bits = MoveMask(FloatNeon{vreinterpretq_f32_u32(vcgtq_f32(distanceSq, vld1q_f32(maxDistanceSq + i)))});
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                outMask[i + lane] = static_cast<uint8_t>((bits >> lane) & 1);
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            float dx = x[i] - listener.x;
+            float dy = y[i] - listener.y;
+            float dz = z[i] - listener.z;
+            outMask[i] = (dx * dx + dy * dy + dz * dz) > maxDistanceSq[i] ? 1 : 0;
+        }
+    }
+
+    void DecibelsToGains(const float* decibels, size_t count, float* outGains)
+    {
+        size_t i = 0;
+        for (; i + FloatV::Width <= count; i += FloatV::Width)
+        {
+            DecibelToGain(FloatV::Load(decibels + i)).Store(outGains + i);
+        }
+        for (; i < count; ++i)
+        {
+            DecibelToGain(FloatScalar::Load(decibels + i)).Store(outGains + i);
+        }
+    }
+
+    void GainsToDecibels(const float* gains, size_t count, float* outDecibels)
+    {
+        size_t i = 0;
+        for (; i + FloatV::Width <= count; i += FloatV::Width)
+        {
+            GainToDecibel(FloatV::Load(gains + i)).Store(outDecibels + i);
+        }
+        for (; i < count; ++i)
+        {
+            GainToDecibel(FloatScalar::Load(gains + i)).Store(outDecibels + i);
+        }
+    }
+
+    // Lane i holds i, for the gain ramps.
+    static const float s_LaneIndices[8] = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f};
+
+    void MixMonoToStereo(const float* in, size_t count, float leftGain, float leftStep, float rightGain, float rightStep, float* outLeft, float* outRight)
+    {
+        size_t i = 0;
+        const FloatV lanes = FloatV::Load(s_LaneIndices);
+        FloatV left = MulAdd(lanes, FloatV::Set(leftStep), FloatV::Set(leftGain));
+        FloatV right = MulAdd(lanes, FloatV::Set(rightStep), FloatV::Set(rightGain));
+        const FloatV leftAdvance = FloatV::Set(leftStep * FloatV::Width);
+        const FloatV rightAdvance = FloatV::Set(rightStep * FloatV::Width);
+        for (; i + FloatV::Width <= count; i += FloatV::Width)
+        {
+            FloatV sample = FloatV::Load(in + i);
+            MulAdd(sample, left, FloatV::Load(outLeft + i)).Store(outLeft + i);
+            MulAdd(sample, right, FloatV::Load(outRight + i)).Store(outRight + i);
+            left = left + leftAdvance;
+            right = right + rightAdvance;
+        }
+        for (; i < count; ++i)
+        {
+            float frame = static_cast<float>(i);
+            outLeft[i] += in[i] * (leftGain + frame * leftStep);
+            outRight[i] += in[i] * (rightGain + frame * rightStep);
+        }
+    }
+
+    void MixStereoToStereo(const float* inLeft, const float* inRight, size_t count, float leftGain, float leftStep, float rightGain, float rightStep, float* outLeft, float* outRight)
+    {
+        size_t i = 0;
+        const FloatV lanes = FloatV::Load(s_LaneIndices);
+        FloatV left = MulAdd(lanes, FloatV::Set(leftStep), FloatV::Set(leftGain));
+        FloatV right = MulAdd(lanes, FloatV::Set(rightStep), FloatV::Set(rightGain));
+        const FloatV leftAdvance = FloatV::Set(leftStep * FloatV::Width);
+        const FloatV rightAdvance = FloatV::Set(rightStep * FloatV::Width);
+        for (; i + FloatV::Width <= count; i += FloatV::Width)
+        {
+            MulAdd(FloatV::Load(inLeft + i), left, FloatV::Load(outLeft + i)).Store(outLeft + i);
+            MulAdd(FloatV::Load(inRight + i), right, FloatV::Load(outRight + i)).Store(outRight + i);
+            left = left + leftAdvance;
+            right = right + rightAdvance;
+        }
+        for (; i < count; ++i)
+        {
+            float frame = static_cast<float>(i);
+            outLeft[i] += inLeft[i] * (leftGain + frame * leftStep);
+            outRight[i] += inRight[i] * (rightGain + frame * rightStep);
+        }
+    }
+
+    void InterleaveStereo(const float* left, const float* right, size_t count, float* out)
+    {
+        size_t i = 0;
+#if VXM_SIMD_AVX2
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 l = _mm256_loadu_ps(left + i);
+            __m256 r = _mm256_loadu_ps(right + i);
+            // The unpacks work inside each 128 bit half, the permutes put the halves back in order.
+            __m256 low = _mm256_unpacklo_ps(l, r);
+            __m256 high = _mm256_unpackhi_ps(l, r);
+            _mm256_storeu_ps(out + 2 * i, _mm256_permute2f128_ps(low, high, 0x20));
+            _mm256_storeu_ps(out + 2 * i + 8, _mm256_permute2f128_ps(low, high, 0x31));
+        }
+#elif VXM_SIMD_SSE2
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 l = _mm_loadu_ps(left + i);
+            __m128 r = _mm_loadu_ps(right + i);
+            _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(l, r));
+            _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(l, r));
+        }
+#elif VXM_SIMD_NEON
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4x2_t frames = {vld1q_f32(left + i), vld1q_f32(right + i)};
+            vst2q_f32(out + 2 * i, frames);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[2 * i] = left[i];
+            out[2 * i + 1] = right[i];
+        }
+    }
+
+    template<typename V>
+    static inline void SpatialGains(V x, V y, V z, V minDistance, V maxDistance, const Vector3& listener, const Vector3& listenerRight, V& outLeft, V& outRight)
+    {
+        const V zero = V::Set(0.0f);
+        const V one = V::Set(1.0f);
+        V dx = x - V::Set(listener.x);
+        V dy = y - V::Set(listener.y);
+        V dz = z - V::Set(listener.z);
+        V distance = Sqrt(MulAdd(dx, dx, MulAdd(dy, dy, dz * dz)));
+
+        // Same curve as the audibility of the engine (AudioEngine::ComputeRolloffGain).
+        V inverse = Select(Less(zero, minDistance), minDistance / Max(distance, minDistance), one);
+        V range = Max(maxDistance - minDistance, V::Set(1e-6f));
+        V taper = Max(one - (distance - minDistance) / range, zero);
+        V rolloff = Select(Less(minDistance, distance), inverse * taper, one);
+
+        // Equal power pan on the projection of the direction on the right axis, centred when the emitter is on the listener.
+        V side = MulAdd(dx, V::Set(listenerRight.x), MulAdd(dy, V::Set(listenerRight.y), dz * V::Set(listenerRight.z)));
+        V t = (side / Max(distance, V::Set(1e-6f)) + one) * V::Set(0.5f);
+        t = Min(Max(t, zero), one);
+        outLeft = rolloff * SinHalfPi(one - t);
+        outRight = rolloff * SinHalfPi(t);
+    }
+
+    void ComputeSpatialGains(const float* x, const float* y, const float* z, const float* minDistance, const float* maxDistance, size_t count,
+                             const Vector3& listener, const Vector3& listenerRight, float* outLeft, float* outRight)
+    {
+        size_t i = 0;
+        for (; i + FloatV::Width <= count; i += FloatV::Width)
+        {
+            FloatV left, right;
+            SpatialGains(FloatV::Load(x + i), FloatV::Load(y + i), FloatV::Load(z + i), FloatV::Load(minDistance + i), FloatV::Load(maxDistance + i), listener, listenerRight, left, right);
+            left.Store(outLeft + i);
+            right.Store(outRight + i);
+        }
+        for (; i < count; ++i)
+        {
+            FloatScalar left, right;
+            SpatialGains(FloatScalar::Load(x + i), FloatScalar::Load(y + i), FloatScalar::Load(z + i), FloatScalar::Load(minDistance + i), FloatScalar::Load(maxDistance + i), listener, listenerRight, left, right);
+            left.Store(outLeft + i);
+            right.Store(outRight + i);
+        }
+    }
+}
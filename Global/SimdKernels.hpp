@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+    #define VXM_SIMD_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define VXM_SIMD_SSE2 1
+#endif
+// Only AArch64 has the division, square root and rounding instructions the kernels need.
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    #define VXM_SIMD_NEON 1
+#endif
+
+namespace Voxymore::Audio::Simd
+{
+    // Name of the instruction set the kernels were compiled with ("AVX2", "SSE2", "NEON" or "Scalar").
+    const char* GetInstructionSet();
+
+    // For each i, outMask[i] = 1 if the squared distance between (x[i], y[i], z[i]) and the listener is greater than maxDistanceSq[i], 0 otherwise.
+    // No square root is computed.
+    void ComputeOutOfRangeMask(const float* x, const float* y, const float* z, const float* maxDistanceSq, size_t count, const Vector3& listener, uint8_t* outMask);
+
+    // outGains[i] = 10^(decibels[i] / 20), relative error below 1e-6 in [-120, 120] dB and 2e-6 in [-200, 200] dB.
+    // outGains may be decibels (in place).
+    void DecibelsToGains(const float* decibels, size_t count, float* outGains);
+    // outDecibels[i] = 20 * log10(gains[i]), error below 2e-7 * max(6, |outDecibels[i]|) dB.
+    // Gains below the smallest normal float (0 included) give about -758 dB instead of -inf. outDecibels may be gains (in place).
+    void GainsToDecibels(const float* gains, size_t count, float* outDecibels);
+
+    // The mix kernels add a voice to the planar stereo bus, with gains ramping linearly from the first frame:
+    // the gain of frame i is gain + i * step, so a gain change is spread over the block instead of clicking.
+    // outLeft[i] += in[i] * leftGain(i), outRight[i] += in[i] * rightGain(i).
+    void MixMonoToStereo(const float* in, size_t count, float leftGain, float leftStep, float rightGain, float rightStep, float* outLeft, float* outRight);
+    // outLeft[i] += inLeft[i] * leftGain(i), outRight[i] += inRight[i] * rightGain(i).
+    void MixStereoToStereo(const float* inLeft, const float* inRight, size_t count, float leftGain, float leftStep, float rightGain, float rightStep, float* outLeft, float* outRight);
+    // out[2 * i] = left[i], out[2 * i + 1] = right[i].
+    void InterleaveStereo(const float* left, const float* right, size_t count, float* out);
+
+    // Gains of emitters at (x[i], y[i], z[i]) for a stereo listener: the inverse tapered rolloff between minDistance[i] and maxDistance[i]
+    // (1 inside minDistance, silent at maxDistance) times an equal power pan along listenerRight (unit length).
+    void ComputeSpatialGains(const float* x, const float* y, const float* z, const float* minDistance, const float* maxDistance, size_t count,
+                             const Vector3& listener, const Vector3& listenerRight, float* outLeft, float* outRight);
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "SimdKernels.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if VXM_SIMD_AVX2 || VXM_SIMD_SSE2
+    #include <immintrin.h>
+#elif VXM_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+// A float vector of the widest instruction set the kernels are compiled with, so a kernel is written once.
+// The Scalar version has a single lane and is also used for the tail of the arrays.
+namespace Voxymore::Audio::Simd
+{
+    struct FloatScalar
+    {
+        static constexpr size_t Width = 1;
+        float v;
+
+        static FloatScalar Load(const float* p) { return {*p}; }
+        static FloatScalar Set(float value) { return {value}; }
+        void Store(float* p) const { *p = v; }
+    };
+
+    // A mask is a vector whose lanes are all bits set (true) or all bits cleared (false).
+    inline FloatScalar MaskFromBool(bool value) { uint32_t bits = value ? 0xFFFFFFFFu : 0u; float f; std::memcpy(&f, &bits, sizeof(f)); return {f}; }
+    inline bool MaskBit(FloatScalar mask) { uint32_t bits; std::memcpy(&bits, &mask.v, sizeof(bits)); return bits != 0; }
+
+    inline FloatScalar operator+(FloatScalar a, FloatScalar b) { return {a.v + b.v}; }
+    inline FloatScalar operator-(FloatScalar a, FloatScalar b) { return {a.v - b.v}; }
+    inline FloatScalar operator*(FloatScalar a, FloatScalar b) { return {a.v * b.v}; }
+    inline FloatScalar operator/(FloatScalar a, FloatScalar b) { return {a.v / b.v}; }
+    inline FloatScalar MulAdd(FloatScalar a, FloatScalar b, FloatScalar c) { return {a.v * b.v + c.v}; }
+    inline FloatScalar Min(FloatScalar a, FloatScalar b) { return {a.v < b.v ? a.v : b.v}; }
+    inline FloatScalar Max(FloatScalar a, FloatScalar b) { return {a.v > b.v ? a.v : b.v}; }
+    inline FloatScalar Less(FloatScalar a, FloatScalar b) { return MaskFromBool(a.v < b.v); }
+    inline FloatScalar Select(FloatScalar mask, FloatScalar ifTrue, FloatScalar ifFalse) { return MaskBit(mask) ? ifTrue : ifFalse; }
+    inline int MoveMask(FloatScalar mask) { return MaskBit(mask) ? 1 : 0; }
+    inline FloatScalar Floor(FloatScalar a) { return {std::floor(a.v)}; }
+    inline FloatScalar Sqrt(FloatScalar a) { return {std::sqrt(a.v)}; }
+    // 2^n for an integer n in [-126, 127] held in a float.
+    inline FloatScalar Pow2Int(FloatScalar n)
+    {
+        uint32_t bits = static_cast<uint32_t>(static_cast<int32_t>(n.v) + 127) << 23;
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return {f};
+    }
+    // x = mantissa * 2^outExponent with the mantissa in [1, 2), for a positive normal x.
+    inline FloatScalar SplitExponent(FloatScalar x, FloatScalar& outExponent)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x.v, sizeof(bits));
+        outExponent = {static_cast<float>(static_cast<int32_t>(bits >> 23) - 127)};
+        bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+        float mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+        return {mantissa};
+    }
+
+#if VXM_SIMD_AVX2
+    struct FloatAvx2
+    {
+        static constexpr size_t Width = 8;
+        __m256 v;
+
+        static FloatAvx2 Load(const float* p) { return {_mm256_loadu_ps(p)}; }
+        static FloatAvx2 Set(float value) { return {_mm256_set1_ps(value)}; }
+        void Store(float* p) const { _mm256_storeu_ps(p, v); }
+    };
+
+    inline FloatAvx2 operator+(FloatAvx2 a, FloatAvx2 b) { return {_mm256_add_ps(a.v, b.v)}; }
+    inline FloatAvx2 operator-(FloatAvx2 a, FloatAvx2 b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    inline FloatAvx2 operator*(FloatAvx2 a, FloatAvx2 b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    inline FloatAvx2 operator/(FloatAvx2 a, FloatAvx2 b) { return {_mm256_div_ps(a.v, b.v)}; }
+    inline FloatAvx2 MulAdd(FloatAvx2 a, FloatAvx2 b, FloatAvx2 c) { return {_mm256_fmadd_ps(a.v, b.v, c.v)}; }
+    inline FloatAvx2 Min(FloatAvx2 a, FloatAvx2 b) { return {_mm256_min_ps(a.v, b.v)}; }
+    inline FloatAvx2 Max(FloatAvx2 a, FloatAvx2 b) { return {_mm256_max_ps(a.v, b.v)}; }
+    inline FloatAvx2 Less(FloatAvx2 a, FloatAvx2 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+    inline FloatAvx2 Select(FloatAvx2 mask, FloatAvx2 ifTrue, FloatAvx2 ifFalse) { return {_mm256_blendv_ps(ifFalse.v, ifTrue.v, mask.v)}; }
+    inline int MoveMask(FloatAvx2 mask) { return _mm256_movemask_ps(mask.v); }
+    inline FloatAvx2 Floor(FloatAvx2 a) { return {_mm256_floor_ps(a.v)}; }
+    inline FloatAvx2 Sqrt(FloatAvx2 a) { return {_mm256_sqrt_ps(a.v)}; }
+    inline FloatAvx2 Pow2Int(FloatAvx2 n)
+    {
+        __m256i bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(n.v), _mm256_set1_epi32(127)), 23);
+        return {_mm256_castsi256_ps(bits)};
+    }
+    inline FloatAvx2 SplitExponent(FloatAvx2 x, FloatAvx2& outExponent)
+    {
+        __m256i bits = _mm256_castps_si256(x.v);
+        outExponent = {_mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)))};
+        bits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F800000));
+        return {_mm256_castsi256_ps(bits)};
+    }
+
+    using FloatV = FloatAvx2;
+#elif VXM_SIMD_SSE2
+    struct FloatSse2
+    {
+        static constexpr size_t Width = 4;
+        __m128 v;
+
+        static FloatSse2 Load(const float* p) { return {_mm_loadu_ps(p)}; }
+        static FloatSse2 Set(float value) { return {_mm_set1_ps(value)}; }
+        void Store(float* p) const { _mm_storeu_ps(p, v); }
+    };
+
+    inline FloatSse2 operator+(FloatSse2 a, FloatSse2 b) { return {_mm_add_ps(a.v, b.v)}; }
+    inline FloatSse2 operator-(FloatSse2 a, FloatSse2 b) { return {_mm_sub_ps(a.v, b.v)}; }
+    inline FloatSse2 operator*(FloatSse2 a, FloatSse2 b) { return {_mm_mul_ps(a.v, b.v)}; }
+    inline FloatSse2 operator/(FloatSse2 a, FloatSse2 b) { return {_mm_div_ps(a.v, b.v)}; }
+    inline FloatSse2 MulAdd(FloatSse2 a, FloatSse2 b, FloatSse2 c) { return {_mm_add_ps(_mm_mul_ps(a.v, b.v), c.v)}; }
+    inline FloatSse2 Min(FloatSse2 a, FloatSse2 b) { return {_mm_min_ps(a.v, b.v)}; }
+    inline FloatSse2 Max(FloatSse2 a, FloatSse2 b) { return {_mm_max_ps(a.v, b.v)}; }
+    inline FloatSse2 Less(FloatSse2 a, FloatSse2 b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+    // SSE2 has no blend, the mask selects the bits.
+    inline FloatSse2 Select(FloatSse2 mask, FloatSse2 ifTrue, FloatSse2 ifFalse) { return {_mm_or_ps(_mm_and_ps(mask.v, ifTrue.v), _mm_andnot_ps(mask.v, ifFalse.v))}; }
+    inline int MoveMask(FloatSse2 mask) { return _mm_movemask_ps(mask.v); }
+    // SSE2 has no floor, truncate then step down the negative values that were rounded up.
+    inline FloatSse2 Floor(FloatSse2 a)
+    {
+        __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+        return {_mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a.v), _mm_set1_ps(1.0f)))};
+    }
+    inline FloatSse2 Sqrt(FloatSse2 a) { return {_mm_sqrt_ps(a.v)}; }
+    inline FloatSse2 Pow2Int(FloatSse2 n)
+    {
+        __m128i bits = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n.v), _mm_set1_epi32(127)), 23);
+        return {_mm_castsi128_ps(bits)};
+    }
+    inline FloatSse2 SplitExponent(FloatSse2 x, FloatSse2& outExponent)
+    {
+        __m128i bits = _mm_castps_si128(x.v);
+        outExponent = {_mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)))};
+        bits = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000));
+        return {_mm_castsi128_ps(bits)};
+    }
+
+    using FloatV = FloatSse2;
+#elif VXM_SIMD_NEON
+    struct FloatNeon
+    {
+        static constexpr size_t Width = 4;
+        float32x4_t v;
+
+        static FloatNeon Load(const float* p) { return {vld1q_f32(p)}; }
+        static FloatNeon Set(float value) { return {vdupq_n_f32(value)}; }
+        void Store(float* p) const { vst1q_f32(p, v); }
+    };
+
+    inline FloatNeon operator+(FloatNeon a, FloatNeon b) { return {vaddq_f32(a.v, b.v)}; }
+    inline FloatNeon operator-(FloatNeon a, FloatNeon b) { return {vsubq_f32(a.v, b.v)}; }
+    inline FloatNeon operator*(FloatNeon a, FloatNeon b) { return {vmulq_f32(a.v, b.v)}; }
+    inline FloatNeon operator/(FloatNeon a, FloatNeon b) { return {vdivq_f32(a.v, b.v)}; }
+    inline FloatNeon MulAdd(FloatNeon a, FloatNeon b, FloatNeon c) { return {vfmaq_f32(c.v, a.v, b.v)}; }
+    inline FloatNeon Min(FloatNeon a, FloatNeon b) { return {vminq_f32(a.v, b.v)}; }
+    inline FloatNeon Max(FloatNeon a, FloatNeon b) { return {vmaxq_f32(a.v, b.v)}; }
+    inline FloatNeon Less(FloatNeon a, FloatNeon b) { return {vreinterpretq_f32_u32(vcltq_f32(a.v, b.v))}; }
+    inline FloatNeon Select(FloatNeon mask, FloatNeon ifTrue, FloatNeon ifFalse) { return {vbslq_f32(vreinterpretq_u32_f32(mask.v), ifTrue.v, ifFalse.v)}; }
+    // NEON has no movemask, the sign bit of each lane is shifted to its position and the lanes are added.
+    inline int MoveMask(FloatNeon mask)
+    {
+        static const int32_t shifts[4] = {0, 1, 2, 3};
+        uint32x4_t bits = vshlq_u32(vshrq_n_u32(vreinterpretq_u32_f32(mask.v), 31), vld1q_s32(shifts));
+        return static_cast<int>(vaddvq_u32(bits));
+    }
+    inline FloatNeon Floor(FloatNeon a) { return {vrndmq_f32(a.v)}; }
+    inline FloatNeon Sqrt(FloatNeon a) { return {vsqrtq_f32(a.v)}; }
+    inline FloatNeon Pow2Int(FloatNeon n)
+    {
+        int32x4_t bits = vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n.v), vdupq_n_s32(127)), 23);
+        return {vreinterpretq_f32_s32(bits)};
+    }
+    inline FloatNeon SplitExponent(FloatNeon x, FloatNeon& outExponent)
+    {
+        uint32x4_t bits = vreinterpretq_u32_f32(x.v);
+        outExponent = {vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127)))};
+        bits = vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007FFFFF)), vdupq_n_u32(0x3F800000));
+        return {vreinterpretq_f32_u32(bits)};
+    }
+
+    using FloatV = FloatNeon;
+#else
+    using FloatV = FloatScalar;
+#endif
+
+    // 2^x, relative error below 2e-7 (the polynomial is a minimax fit of 2^f on [0, 1), 7.5e-8, plus the float rounding).
+    // x is clamped to [-126, 127], so the result is never a denormal nor an infinity.
+    template<typename V>
+    inline V Exp2(V x)
+    {
+        x = Min(Max(x, V::Set(-126.0f)), V::Set(127.0f));
+        V whole = Floor(x);
+        V f = x - whole;
+        V p = V::Set(0.0018775715f);
+        p = MulAdd(p, f, V::Set(0.0089893525f));
+        p = MulAdd(p, f, V::Set(0.055826308f));
+        p = MulAdd(p, f, V::Set(0.24015362f));
+        p = MulAdd(p, f, V::Set(0.69315307f));
+        p = MulAdd(p, f, V::Set(0.99999993f));
+        return p * Pow2Int(whole);
+    }
+
+    // 10^(dB / 20), relative error below 1e-6 in [-120, 120] dB and 2e-6 in [-200, 200] dB
+    // (Exp2 plus the rounding of its argument, which grows with |dB|).
+    template<typename V>
+    inline V DecibelToGain(V decibel)
+    {
+        // log2(10) / 20
+        return Exp2(decibel * V::Set(0.16609640f));
+    }
+
+    // log2(x), error below 1e-7 * max(1, |log2(x)|) (the series truncation is 4e-9, the rest is the float rounding).
+    // x is clamped to the smallest normal float, so 0 and the negative values give -126 instead of -inf or NaN.
+    template<typename V>
+    inline V Log2(V x)
+    {
+        x = Max(x, V::Set(1.17549435e-38f));
+        V exponent;
+        V mantissa = SplitExponent(x, exponent);
+        // Centre the mantissa on 1, in [sqrt(0.5), sqrt(2)), so |z| stays below 0.172.
+        V high = Less(V::Set(1.41421356f), mantissa);
+        mantissa = Select(high, mantissa * V::Set(0.5f), mantissa);
+        exponent = Select(high, exponent + V::Set(1.0f), exponent);
+
+        // log2(m) = 2 / ln(2) * atanh(z) with z = (m - 1) / (m + 1), odd series up to z^9.
+        V one = V::Set(1.0f);
+        V z = (mantissa - one) / (mantissa + one);
+        V z2 = z * z;
+        V p = V::Set(0.32059890f);
+        p = MulAdd(p, z2, V::Set(0.41219858f));
+        p = MulAdd(p, z2, V::Set(0.57707802f));
+        p = MulAdd(p, z2, V::Set(0.96179669f));
+        p = MulAdd(p, z2, V::Set(2.8853901f));
+        return MulAdd(p, z, exponent);
+    }
+
+    // 20 * log10(gain), error below 2e-7 * max(6, |result|) dB. A gain of 0 gives about -758 dB instead of -inf.
+    template<typename V>
+    inline V GainToDecibel(V gain)
+    {
+        // 20 * log10(2)
+        return Log2(gain) * V::Set(6.0205999f);
+    }
+
+    // sin(t * pi / 2) for t in [0, 1], absolute error below 2.5e-7 (the minimax polynomial is within 4e-9, the rest is the float rounding).
+    template<typename V>
+    inline V SinHalfPi(V t)
+    {
+        V t2 = t * t;
+        V p = V::Set(0.00015082056f);
+        p = MulAdd(p, t2, V::Set(-0.0046722279f));
+        p = MulAdd(p, t2, V::Set(0.079688481f));
+        p = MulAdd(p, t2, V::Set(-0.64596336f));
+        p = MulAdd(p, t2, V::Set(1.5707963f));
+        return p * t;
+    }
+}
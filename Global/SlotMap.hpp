@@ -0,0 +1,297 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    // A TypeId handle is split in two parts :
+    //  - the low bits are the index of the slot in the slot table,
+    //  - the high bits are the generation of the slot when the handle was created.
+    // Every time a slot is freed its generation is bumped, so a handle to an erased element is detected as stale.
+    namespace SlotHandle
+    {
+        inline constexpr uint32_t IndexBits = 20;
+        inline constexpr uint32_t GenerationBits = 32 - IndexBits;
+        inline constexpr uint32_t IndexMask = (1u << IndexBits) - 1u;
+        inline constexpr uint32_t GenerationMask = (1u << GenerationBits) - 1u;
+        inline constexpr uint32_t MaxSlots = IndexMask + 1u;
+
+        inline constexpr TypeId Make(uint32_t index, uint32_t generation) { return (generation << IndexBits) | (index & IndexMask); }
+        inline constexpr uint32_t Index(TypeId id) { return id & IndexMask; }
+        inline constexpr uint32_t Generation(TypeId id) { return (id >> IndexBits) & GenerationMask; }
+
+        // The generation 0 is never given to a live slot, that way NullId (index 0, generation 0) is always invalid.
+        inline constexpr uint32_t NextGeneration(uint32_t generation)
+        {
+            generation = (generation + 1u) & GenerationMask;
+            return generation == 0 ? 1u : generation;
+        }
+    }
+
+    // Map generational handles to dense indices [0, Size()).
+    // It only does the bookkeeping, the owner keeps its data in arrays indexed by the dense index
+    // and must mirror the swap done by Erase (the last element is moved in the hole).
+    //
+    // Getting a handle is split from inserting the element: AcquireHandle is lock-free and can be called from any thread,
+    // every other function must be called from the thread owning the data.
+    // The slot table has a fixed capacity so it never reallocates under the feet of the other threads.
+    // The free slots form a FIFO ring: the slot freed the longest time ago is given first, so a slot comes back only after every
+    // other free slot and its generation wraps after GenerationMask times the free slots reuses, not GenerationMask reuses.
+    // Only the owning thread pushes, the other threads pop by moving the 64 bits head, which never wraps so there is no ABA.
+    class SlotTable
+    {
+    public:
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+    private:
+        enum class SlotState : uint8_t { Free, Acquired, Live };
+
+        struct Slot
+        {
+            uint32_t DenseIndex = InvalidIndex;
+            uint32_t Generation = 1;
+            std::atomic<SlotState> State = SlotState::Free;
+        };
+    public:
+        // Must be called before any handle is given.
+        void SetCapacity(uint32_t capacity)
+        {
+            m_Capacity = std::min(capacity, SlotHandle::MaxSlots);
+            m_Slots = std::make_unique<Slot[]>(m_Capacity);
+            m_DenseToSlot.clear();
+            m_DenseToSlot.reserve(m_Capacity);
+            // Every slot starts free, in order.
+            m_FreeSlots = std::make_unique<std::atomic<uint32_t>[]>(m_Capacity);
+            for (uint32_t slotIndex = 0; slotIndex < m_Capacity; ++slotIndex) m_FreeSlots[slotIndex].store(slotIndex, std::memory_order_relaxed);
+            m_FreeHead.store(0, std::memory_order_relaxed);
+            m_FreeTail.store(m_Capacity, std::memory_order_release);
+        }
+
+        uint32_t GetCapacity() const { return m_Capacity; }
+
+        // Thread safe. The handle is valid but Find returns InvalidIndex until Insert is called.
+        // Return NullId when the table is full.
+        TypeId AcquireHandle()
+        {
+            uint32_t slotIndex = PopFreeSlot();
+            if(slotIndex == InvalidIndex) return NullId;
+
+            Slot& slot = m_Slots[slotIndex];
+            slot.State.store(SlotState::Acquired, std::memory_order_relaxed);
+            return SlotHandle::Make(slotIndex, slot.Generation);
+        }
+
+        // Give a dense index to an acquired handle, it is always the previous Size().
+        bool Insert(TypeId id)
+        {
+            uint32_t slotIndex = SlotHandle::Index(id);
+            if(slotIndex >= m_Capacity) return false;
+            Slot& slot = m_Slots[slotIndex];
+            if(slot.State.load(std::memory_order_relaxed) != SlotState::Acquired || slot.Generation != SlotHandle::Generation(id)) return false;
+
+            slot.State.store(SlotState::Live, std::memory_order_relaxed);
+            slot.DenseIndex = static_cast<uint32_t>(m_DenseToSlot.size());
+            m_DenseToSlot.push_back(slotIndex);
+            return true;
+        }
+
+        TypeId Allocate()
+        {
+            TypeId id = AcquireHandle();
+            if(id != NullId) Insert(id);
+            return id;
+        }
+
+        // Return the dense index that was freed (where the last element must be moved), InvalidIndex if the handle is stale.
+        // An acquired handle that was never inserted is released as well (and InvalidIndex is returned).
+        uint32_t Erase(TypeId id)
+        {
+            uint32_t slotIndex = SlotHandle::Index(id);
+            if(slotIndex >= m_Capacity) return InvalidIndex;
+            Slot& slot = m_Slots[slotIndex];
+            if(slot.Generation != SlotHandle::Generation(id)) return InvalidIndex;
+
+            SlotState state = slot.State.load(std::memory_order_relaxed);
+            if(state == SlotState::Acquired)
+            {
+                Release(slotIndex);
+                return InvalidIndex;
+            }
+            if(state != SlotState::Live) return InvalidIndex;
+
+            uint32_t denseIndex = slot.DenseIndex;
+            uint32_t lastIndex = static_cast<uint32_t>(m_DenseToSlot.size() - 1);
+            if(denseIndex != lastIndex)
+            {
+                m_DenseToSlot[denseIndex] = m_DenseToSlot[lastIndex];
+                m_Slots[m_DenseToSlot[denseIndex]].DenseIndex = denseIndex;
+            }
+            m_DenseToSlot.pop_back();
+
+            Release(slotIndex);
+            return denseIndex;
+        }
+
+        // Exchange the dense indices of two elements, the owner must swap its data the same way.
+        void Swap(uint32_t denseA, uint32_t denseB)
+        {
+            std::swap(m_DenseToSlot[denseA], m_DenseToSlot[denseB]);
+            m_Slots[m_DenseToSlot[denseA]].DenseIndex = denseA;
+            m_Slots[m_DenseToSlot[denseB]].DenseIndex = denseB;
+        }
+
+        void Clear()
+        {
+            for (uint32_t slotIndex : m_DenseToSlot)
+            {
+                Release(slotIndex);
+            }
+            m_DenseToSlot.clear();
+        }
+
+        // Return InvalidIndex if the handle is stale, invalid or not inserted yet.
+        uint32_t Find(TypeId id) const
+        {
+            uint32_t slotIndex = SlotHandle::Index(id);
+            if(slotIndex >= m_Capacity) return InvalidIndex;
+            const Slot& slot = m_Slots[slotIndex];
+            if(slot.Generation != SlotHandle::Generation(id)) return InvalidIndex;
+            return slot.DenseIndex;
+        }
+
+        TypeId HandleAt(size_t denseIndex) const
+        {
+            uint32_t slotIndex = m_DenseToSlot[denseIndex];
+            return SlotHandle::Make(slotIndex, m_Slots[slotIndex].Generation);
+        }
+
+        size_t Size() const { return m_DenseToSlot.size(); }
+    private:
+        void Release(uint32_t slotIndex)
+        {
+            Slot& slot = m_Slots[slotIndex];
+            slot.Generation = SlotHandle::NextGeneration(slot.Generation);
+            slot.DenseIndex = InvalidIndex;
+            slot.State.store(SlotState::Free, std::memory_order_relaxed);
+
+            // The ring never holds more than the capacity: the released slot wasn't in it.
+            // The release store of the tail publishes the new generation to the thread that pops the slot.
+            uint64_t tail = m_FreeTail.load(std::memory_order_relaxed);
+            m_FreeSlots[tail % m_Capacity].store(slotIndex, std::memory_order_relaxed);
+            m_FreeTail.store(tail + 1, std::memory_order_release);
+        }
+
+        uint32_t PopFreeSlot()
+        {
+            uint64_t head = m_FreeHead.load(std::memory_order_relaxed);
+            uint32_t slotIndex;
+            do
+            {
+                if(head == m_FreeTail.load(std::memory_order_acquire)) return InvalidIndex;
+                // The cell may be overwritten if another thread popped it in between, the exchange fails in that case.
+                slotIndex = m_FreeSlots[head % m_Capacity].load(std::memory_order_relaxed);
+            } while (!m_FreeHead.compare_exchange_weak(head, head + 1, std::memory_order_relaxed));
+            return slotIndex;
+        }
+    private:
+        std::vector<uint32_t> m_DenseToSlot;
+        std::unique_ptr<Slot[]> m_Slots;
+        uint32_t m_Capacity = 0;
+        // Ring of the free slot indices, m_FreeHead is the next one given, m_FreeTail where the next freed one goes.
+        std::unique_ptr<std::atomic<uint32_t>[]> m_FreeSlots;
+        std::atomic<uint64_t> m_FreeHead = 0;
+        std::atomic<uint64_t> m_FreeTail = 0;
+    };
+
+    // Store the values densely (so they can be iterated linearly) and give back generational handles.
+    // Lookups are two array accesses, no hashing involved.
+    // Erasing swap the last value in the hole, so the order of the values is not stable.
+    template<typename T>
+    class SlotMap
+    {
+    public:
+        template<typename... Args>
+        TypeId Emplace(Args&&... args)
+        {
+            TypeId id = m_Table.AcquireHandle();
+            if(id == NullId) return id;
+            Insert(id, std::forward<Args>(args)...);
+            return id;
+        }
+
+        // Thread safe, see SlotTable::AcquireHandle.
+        TypeId AcquireHandle() { return m_Table.AcquireHandle(); }
+
+        // Construct the value of a handle given by AcquireHandle.
+        template<typename... Args>
+        bool Insert(TypeId id, Args&&... args)
+        {
+            if(!m_Table.Insert(id)) return false;
+            m_Values.emplace_back(std::forward<Args>(args)...);
+            return true;
+        }
+
+        // Return a nullptr if the handle is stale or invalid.
+        T* Get(TypeId id)
+        {
+            uint32_t denseIndex = m_Table.Find(id);
+            return denseIndex == SlotTable::InvalidIndex ? nullptr : &m_Values[denseIndex];
+        }
+
+        const T* Get(TypeId id) const
+        {
+            uint32_t denseIndex = m_Table.Find(id);
+            return denseIndex == SlotTable::InvalidIndex ? nullptr : &m_Values[denseIndex];
+        }
+
+        bool Contains(TypeId id) const
+        {
+            return m_Table.Find(id) != SlotTable::InvalidIndex;
+        }
+
+        bool Erase(TypeId id)
+        {
+            uint32_t denseIndex = m_Table.Erase(id);
+            if(denseIndex == SlotTable::InvalidIndex) return false;
+
+            if(denseIndex != m_Values.size() - 1)
+            {
+                m_Values[denseIndex] = std::move(m_Values.back());
+            }
+            m_Values.pop_back();
+            return true;
+        }
+
+        void Clear()
+        {
+            m_Table.Clear();
+            m_Values.clear();
+        }
+
+        void SetCapacity(uint32_t capacity)
+        {
+            m_Table.SetCapacity(capacity);
+            m_Values.clear();
+            m_Values.reserve(m_Table.GetCapacity());
+        }
+
+        uint32_t GetCapacity() const { return m_Table.GetCapacity(); }
+
+        size_t Size() const { return m_Values.size(); }
+        bool Empty() const { return m_Values.empty(); }
+
+        // Dense access, the index is only valid until the next Emplace or Erase.
+        std::span<T> Values() { return m_Values; }
+        std::span<const T> Values() const { return m_Values; }
+        TypeId HandleAt(size_t denseIndex) const { return m_Table.HandleAt(denseIndex); }
+    private:
+        SlotTable m_Table;
+        std::vector<T> m_Values;
+    };
+}
@@ -0,0 +1,43 @@
+#include "SoundCache.hpp"
+#include <functional>
+
+namespace Voxymore::Audio
+{
+    size_t SoundLoadKeyHash::operator()(const SoundDefinition& definition) const
+    {
+        size_t hash = std::hash<std::string>{}(definition.name);
+        auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2); };
+        combine(std::hash<float>{}(definition.minDistance));
+        combine(std::hash<float>{}(definition.maxDistance));
+        combine((definition.is3D ? 1u : 0u) | (definition.isLooping ? 2u : 0u) | (definition.isStream ? 4u : 0u));
+        return hash;
+    }
+
+    bool SoundLoadKeyEqual::operator()(const SoundDefinition& a, const SoundDefinition& b) const
+    {
+        return a.name == b.name
+            && a.minDistance == b.minDistance
+            && a.maxDistance == b.maxDistance
+            && a.is3D == b.is3D
+            && a.isLooping == b.isLooping
+            && a.isStream == b.isStream;
+    }
+
+    bool SoundCache::Find(TypeId soundId, const SoundDefinition*& outDefinition, Entry*& outEntry) const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_Mutex);
+        auto it = m_ById.find(soundId);
+        if(it == m_ById.end()) return false;
+
+        outDefinition = &it->second->first;
+        outEntry = &it->second->second;
+        return true;
+    }
+
+    void SoundCache::Release(TypeId soundId)
+    {
+        std::shared_lock<std::shared_mutex> lock(m_Mutex);
+        auto it = m_ById.find(soundId);
+        if(it != m_ById.end()) Release(it->second->second);
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    // Hash and compare only the parts of a SoundDefinition that change how the sound is loaded.
+    struct SoundLoadKeyHash
+    {
+        size_t operator()(const SoundDefinition& definition) const;
+    };
+
+    struct SoundLoadKeyEqual
+    {
+        bool operator()(const SoundDefinition& a, const SoundDefinition& b) const;
+    };
+
+    // Share one sound between every one shot played with the same loaded content.
+    // Each entry is reference counted by the channels using it (and the plays still in the command queue),
+    // the unreferenced entries are kept loaded and evicted by least recent use once the cache is over its capacity.
+    // The entries are only scanned again when a reference count dropped to 0 since the last trim.
+    //
+    // Acquire and Release can be called from any thread, everything else from the engine thread.
+    class SoundCache
+    {
+    public:
+        struct Entry
+        {
+            explicit Entry(TypeId soundId) : SoundId(soundId) {}
+
+            TypeId SoundId;
+            std::atomic<uint32_t> References = 1;
+            std::atomic<uint64_t> LastUse = 0;
+        };
+    public:
+        // Return the sound of the definition with a new reference, NullId if acquireSoundId() failed to give an id.
+        // The first play of a new sound finds it missing, the engine then creates it with FindDefinition.
+        template<typename AcquireFunc>
+        TypeId Acquire(const SoundDefinition& definition, AcquireFunc&& acquireSoundId)
+        {
+            uint64_t use = m_UseCounter.fetch_add(1, std::memory_order_relaxed) + 1;
+            {
+                std::shared_lock<std::shared_mutex> lock(m_Mutex);
+                auto it = m_Entries.find(definition);
+                if(it != m_Entries.end())
+                {
+                    Entry& entry = it->second;
+                    entry.References.fetch_add(1, std::memory_order_relaxed);
+                    entry.LastUse.store(use, std::memory_order_relaxed);
+                    return entry.SoundId;
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> lock(m_Mutex);
+            auto it = m_Entries.find(definition);
+            if(it != m_Entries.end())
+            {
+                it->second.References.fetch_add(1, std::memory_order_relaxed);
+                it->second.LastUse.store(use, std::memory_order_relaxed);
+                return it->second.SoundId;
+            }
+
+            TypeId soundId = acquireSoundId();
+            if(soundId == NullId) return NullId;
+
+            auto& pair = *m_Entries.try_emplace(definition, soundId).first;
+            pair.second.LastUse.store(use, std::memory_order_relaxed);
+            m_ById.emplace(soundId, &pair);
+            m_Size.store(m_Entries.size(), std::memory_order_relaxed);
+            return soundId;
+        }
+
+        void Release(Entry& entry)
+        {
+            if(entry.References.fetch_sub(1, std::memory_order_release) == 1) m_HasUnreferenced.store(true, std::memory_order_release);
+        }
+
+        // Return false if the sound isn't cached.
+        bool Find(TypeId soundId, const SoundDefinition*& outDefinition, Entry*& outEntry) const;
+        // Release the reference taken by Acquire when the play never reached the engine.
+        void Release(TypeId soundId);
+
+        size_t Size() const { return m_Size.load(std::memory_order_relaxed); }
+
+        // Evict the least recently used unreferenced entries until the cache holds at most capacity entries.
+        // onEvict(TypeId) must destroy the sound and give its id back.
+        template<typename EvictFunc>
+        void Trim(size_t capacity, EvictFunc&& onEvict)
+        {
+            std::unique_lock<std::shared_mutex> lock(m_Mutex);
+            if(m_Entries.size() <= capacity) return;
+            // Every entry left by the last trim is still referenced.
+            if(!m_HasUnreferenced.exchange(false, std::memory_order_acquire)) return;
+
+            m_EvictionCandidates.clear();
+            for (auto& pair : m_Entries)
+            {
+                if(pair.second.References.load(std::memory_order_acquire) == 0) m_EvictionCandidates.push_back(&pair);
+            }
+
+            size_t count = std::min(m_Entries.size() - capacity, m_EvictionCandidates.size());
+            std::partial_sort(m_EvictionCandidates.begin(), m_EvictionCandidates.begin() + static_cast<std::ptrdiff_t>(count), m_EvictionCandidates.end(), [](const auto* a, const auto* b)
+            {
+                return a->second.LastUse.load(std::memory_order_relaxed) < b->second.LastUse.load(std::memory_order_relaxed);
+            });
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                TypeId soundId = m_EvictionCandidates[i]->second.SoundId;
+                onEvict(soundId);
+                m_ById.erase(soundId);
+                m_Entries.erase(m_EvictionCandidates[i]->first);
+            }
+            // The candidates left are evicted when the cache grows again.
+            if(count < m_EvictionCandidates.size()) m_HasUnreferenced.store(true, std::memory_order_relaxed);
+            m_Size.store(m_Entries.size(), std::memory_order_relaxed);
+        }
+    private:
+        using EntryMap = std::unordered_map<SoundDefinition, Entry, SoundLoadKeyHash, SoundLoadKeyEqual>;
+        mutable std::shared_mutex m_Mutex;
+        EntryMap m_Entries;
+        // The nodes of an unordered_map never move, so the pointers stay valid until the entry is erased.
+        std::unordered_map<TypeId, EntryMap::value_type*> m_ById;
+        std::vector<EntryMap::value_type*> m_EvictionCandidates;
+        // Set when a reference count drops to 0, cleared by Trim.
+        std::atomic<bool> m_HasUnreferenced = false;
+        std::atomic<uint64_t> m_UseCounter = 0;
+        std::atomic<size_t> m_Size = 0;
+    };
+}
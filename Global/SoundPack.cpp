@@ -0,0 +1,140 @@
+#include "SoundPack.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    uint64_t SoundPack::HashName(std::string_view name)
+    {
+        // FNV-1a, stable across platforms and compilers, which std::hash is not.
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (char c : name)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    bool SoundPack::Build(std::span<const std::filesystem::path> files, const std::filesystem::path& root, const std::filesystem::path& packPath, uint32_t alignment)
+    {
+        alignment = std::max(alignment, 1u);
+        auto alignUp = [alignment](uint64_t value) { return (value + alignment - 1) / alignment * alignment; };
+
+        struct Source
+        {
+            std::string Name;
+            std::filesystem::path Path;
+            uint64_t Size;
+        };
+
+        std::vector<Source> sources;
+        sources.reserve(files.size());
+        for (const std::filesystem::path& file : files)
+        {
+            std::error_code error;
+            uint64_t size = std::filesystem::file_size(file, error);
+            if(error) return false;
+            sources.push_back({file.lexically_relative(root).generic_string(), file, size});
+        }
+
+        std::vector<Entry> entries(sources.size());
+        std::string names;
+        Header header{};
+        header.Magic = Magic;
+        header.Version = Version;
+        header.EntryCount = static_cast<uint32_t>(sources.size());
+        header.DataAlignment = alignment;
+        header.IndexOffset = sizeof(Header);
+        header.NamesOffset = header.IndexOffset + entries.size() * sizeof(Entry);
+
+        for (size_t i = 0; i < sources.size(); ++i)
+        {
+            entries[i].NameHash = HashName(sources[i].Name);
+            entries[i].NameOffset = static_cast<uint32_t>(header.NamesOffset + names.size());
+            entries[i].NameSize = static_cast<uint32_t>(sources[i].Name.size());
+            entries[i].DataSize = sources[i].Size;
+            names += sources[i].Name;
+        }
+        header.NamesSize = names.size();
+
+        uint64_t offset = header.NamesOffset + header.NamesSize;
+        for (Entry& entry : entries)
+        {
+            offset = alignUp(offset);
+            entry.DataOffset = offset;
+            offset += entry.DataSize;
+        }
+
+        // The data is written in the order of the files, only the index is sorted.
+        std::vector<Entry> index = entries;
+        std::sort(index.begin(), index.end(), [](const Entry& a, const Entry& b) { return a.NameHash < b.NameHash; });
+
+        std::ofstream pack(packPath, std::ios::binary | std::ios::trunc);
+        if(!pack) return false;
+        pack.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        pack.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(Entry)));
+        pack.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+        std::vector<char> buffer;
+        uint64_t written = header.NamesOffset + header.NamesSize;
+        for (size_t i = 0; i < sources.size(); ++i)
+        {
+            buffer.assign(entries[i].DataOffset - written, 0);
+            buffer.resize(buffer.size() + entries[i].DataSize);
+            std::ifstream file(sources[i].Path, std::ios::binary);
+            if(!file.read(buffer.data() + (entries[i].DataOffset - written), static_cast<std::streamsize>(entries[i].DataSize))) return false;
+            pack.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            written = entries[i].DataOffset + entries[i].DataSize;
+        }
+        return static_cast<bool>(pack);
+    }
+
+    bool SoundPack::Open(const std::filesystem::path& packPath)
+    {
+        m_Entries = nullptr;
+        m_Count = 0;
+        if(!m_File.Open(packPath)) return false;
+
+        std::span<const std::byte> bytes = m_File.Bytes();
+        Header header;
+        if(bytes.size() < sizeof(Header)) return false;
+        std::memcpy(&header, bytes.data(), sizeof(Header));
+        if(header.Magic != Magic || header.Version != Version) return false;
+
+        if(header.IndexOffset % alignof(Entry) != 0 || header.IndexOffset + uint64_t(header.EntryCount) * sizeof(Entry) > bytes.size()) return false;
+        if(header.NamesOffset + header.NamesSize > bytes.size()) return false;
+
+        // Check the entries once, so Find doesn't have to.
+        const Entry* entries = reinterpret_cast<const Entry*>(bytes.data() + header.IndexOffset);
+        for (uint32_t i = 0; i < header.EntryCount; ++i)
+        {
+            const Entry& entry = entries[i];
+            if(entry.NameOffset < header.NamesOffset || uint64_t(entry.NameOffset) + entry.NameSize > header.NamesOffset + header.NamesSize) return false;
+            if(entry.DataOffset > bytes.size() || entry.DataSize > bytes.size() - entry.DataOffset) return false;
+            if(i > 0 && entries[i - 1].NameHash > entry.NameHash) return false;
+        }
+
+        m_Entries = entries;
+        m_Count = header.EntryCount;
+        return true;
+    }
+
+    std::span<const std::byte> SoundPack::Find(std::string_view name) const
+    {
+        uint64_t hash = HashName(name);
+        const Entry* end = m_Entries + m_Count;
+        const Entry* it = std::lower_bound(m_Entries, end, hash, [](const Entry& entry, uint64_t value) { return entry.NameHash < value; });
+
+        // Different names may share a hash, they are next to each other in the index.
+        for (; it != end && it->NameHash == hash; ++it)
+        {
+            std::string_view entryName(reinterpret_cast<const char*>(m_File.Data() + it->NameOffset), it->NameSize);
+            if(entryName == name) return {m_File.Data() + it->DataOffset, it->DataSize};
+        }
+        return {};
+    }
+}
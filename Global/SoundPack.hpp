@@ -0,0 +1,64 @@
+#pragma once
+
+#include "MappedFile.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+namespace Voxymore::Audio
+{
+    // A single file holding the data of many sounds, read in place through a memory mapping.
+    //
+    // Layout: a header, the index (entries sorted by the hash of their name), the names, then the data of each entry
+    // aligned on DataAlignment bytes. Every offset is relative to the start of the file, every value is little endian.
+    // The name of an entry is the path of its source file relative to the root given to Build, with '/' separators.
+    class SoundPack
+    {
+    public:
+        static constexpr uint32_t Magic = 0x4B505856; // "VXPK"
+        static constexpr uint32_t Version = 1;
+        static constexpr uint32_t DefaultAlignment = 64;
+
+        struct Header
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t EntryCount;
+            uint32_t DataAlignment;
+            uint64_t IndexOffset;
+            uint64_t NamesOffset;
+            uint64_t NamesSize;
+        };
+
+        struct Entry
+        {
+            uint64_t NameHash;
+            uint64_t DataOffset;
+            uint64_t DataSize;
+            uint32_t NameOffset;
+            uint32_t NameSize;
+        };
+
+        static_assert(sizeof(Header) == 40 && sizeof(Entry) == 32, "The pack layout is part of the file format.");
+
+        static uint64_t HashName(std::string_view name);
+
+        // Pack the files, named by their path relative to root. Return false if a file can't be read or the pack written.
+        static bool Build(std::span<const std::filesystem::path> files, const std::filesystem::path& root, const std::filesystem::path& packPath, uint32_t alignment = DefaultAlignment);
+
+        // Map the pack, return false if it can't be mapped or isn't a valid pack of this version.
+        bool Open(const std::filesystem::path& packPath);
+
+        // The data of the entry, empty if the pack has no entry with this name.
+        // The bytes stay valid as long as the pack is open.
+        std::span<const std::byte> Find(std::string_view name) const;
+
+        uint32_t Count() const { return m_Count; }
+    private:
+        MappedFile m_File;
+        const Entry* m_Entries = nullptr;
+        uint32_t m_Count = 0;
+    };
+}
@@ -0,0 +1,163 @@
+#include "SoundRegistry.hpp"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <yaml-cpp/yaml.h>
+
+namespace Voxymore::Audio::SoundRegistry
+{
+    bool LoadManifest(const std::filesystem::path& manifestPath, std::vector<SoundDefinition>& outDefinitions)
+    {
+        YAML::Node sounds;
+        try
+        {
+            sounds = YAML::LoadFile(manifestPath.string())["Voxaudio.Sounds"];
+        }
+        catch (const YAML::Exception& e)
+        {
+            std::cerr << "Voxaudio ERROR : can't read the sound manifest " << manifestPath << " : " << e.what() << std::endl;
+            return false;
+        }
+        if(!sounds || !sounds.IsSequence()) return false;
+
+        size_t previousSize = outDefinitions.size();
+        outDefinitions.reserve(previousSize + sounds.size());
+        try
+        {
+            for (const YAML::Node& sound : sounds)
+            {
+                SoundDefinition& definition = outDefinitions.emplace_back();
+                definition.name = sound["Name"].as<std::string>();
+                if(sound["DefaultVolumedB"]) definition.defaultVolumedB = sound["DefaultVolumedB"].as<float>();
+                if(sound["MinDistance"]) definition.minDistance = sound["MinDistance"].as<float>();
+                if(sound["MaxDistance"]) definition.maxDistance = sound["MaxDistance"].as<float>();
+                if(sound["Priority"]) definition.priority = sound["Priority"].as<float>();
+                if(sound["Is3D"]) definition.is3D = sound["Is3D"].as<bool>();
+                if(sound["IsLooping"]) definition.isLooping = sound["IsLooping"].as<bool>();
+                if(sound["IsStream"]) definition.isStream = sound["IsStream"].as<bool>();
+                if(sound["Pinned"]) definition.pinned = sound["Pinned"].as<bool>();
+            }
+        }
+        catch (const YAML::Exception& e)
+        {
+            std::cerr << "Voxaudio ERROR : invalid sound in the manifest " << manifestPath << " : " << e.what() << std::endl;
+            outDefinitions.resize(previousSize);
+            return false;
+        }
+        return true;
+    }
+
+    bool SaveManifest(const std::filesystem::path& manifestPath, std::span<const SoundDefinition> definitions)
+    {
+        YAML::Node root;
+        YAML::Node sounds = root["Voxaudio.Sounds"];
+        for (const SoundDefinition& definition : definitions)
+        {
+            YAML::Node sound;
+            sound["Name"] = definition.name;
+            sound["DefaultVolumedB"] = definition.defaultVolumedB;
+            sound["MinDistance"] = definition.minDistance;
+            sound["MaxDistance"] = definition.maxDistance;
+            sound["Priority"] = definition.priority;
+            sound["Is3D"] = definition.is3D;
+            sound["IsLooping"] = definition.isLooping;
+            sound["IsStream"] = definition.isStream;
+            sound["Pinned"] = definition.pinned;
+            sounds.push_back(sound);
+        }
+
+        std::ofstream file(manifestPath);
+        if(!file) return false;
+        file << root;
+        return static_cast<bool>(file);
+    }
+
+    bool Compile(std::span<const SoundDefinition> definitions, const std::filesystem::path& registryPath)
+    {
+        std::vector<Record> records;
+        records.reserve(definitions.size());
+        std::string names;
+
+        Header header{};
+        header.Magic = Magic;
+        header.Version = Version;
+        header.Count = static_cast<uint32_t>(definitions.size());
+        header.RecordsOffset = sizeof(Header);
+        header.NamesOffset = header.RecordsOffset + static_cast<uint32_t>(definitions.size() * sizeof(Record));
+
+        for (const SoundDefinition& definition : definitions)
+        {
+            Record& record = records.emplace_back();
+            record.NameOffset = header.NamesOffset + static_cast<uint32_t>(names.size());
+            record.NameSize = static_cast<uint32_t>(definition.name.size());
+            record.DefaultVolumedB = definition.defaultVolumedB;
+            record.MinDistance = definition.minDistance;
+            record.MaxDistance = definition.maxDistance;
+            record.Priority = definition.priority;
+            record.Flags = (definition.is3D ? Is3D : 0u)
+                         | (definition.isLooping ? IsLooping : 0u)
+                         | (definition.isStream ? IsStream : 0u)
+                         | (definition.pinned ? Pinned : 0u);
+            names += definition.name;
+        }
+        header.NamesSize = static_cast<uint32_t>(names.size());
+
+        std::ofstream file(registryPath, std::ios::binary | std::ios::trunc);
+        if(!file) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Record)));
+        file.write(names.data(), static_cast<std::streamsize>(names.size()));
+        return static_cast<bool>(file);
+    }
+
+    bool View::Open(std::span<const std::byte> bytes)
+    {
+        m_Bytes = {};
+        m_Records = nullptr;
+        m_Count = 0;
+
+        Header header;
+        if(bytes.size() < sizeof(Header)) return false;
+        std::memcpy(&header, bytes.data(), sizeof(Header));
+        if(header.Magic != Magic || header.Version != Version) return false;
+
+        uint64_t recordsEnd = uint64_t(header.RecordsOffset) + uint64_t(header.Count) * sizeof(Record);
+        uint64_t namesEnd = uint64_t(header.NamesOffset) + header.NamesSize;
+        if(header.RecordsOffset % alignof(Record) != 0 || recordsEnd > bytes.size() || namesEnd > bytes.size()) return false;
+
+        // Check the names once, so the accessors don't have to.
+        const Record* records = reinterpret_cast<const Record*>(bytes.data() + header.RecordsOffset);
+        for (uint32_t i = 0; i < header.Count; ++i)
+        {
+            uint64_t nameEnd = uint64_t(records[i].NameOffset) + records[i].NameSize;
+            if(records[i].NameOffset < header.NamesOffset || nameEnd > namesEnd) return false;
+        }
+
+        m_Bytes = bytes;
+        m_Records = records;
+        m_Count = header.Count;
+        return true;
+    }
+
+    std::string_view View::Name(uint32_t index) const
+    {
+        const Record& record = m_Records[index];
+        return {reinterpret_cast<const char*>(m_Bytes.data() + record.NameOffset), record.NameSize};
+    }
+
+    SoundDefinition View::Definition(uint32_t index) const
+    {
+        const Record& record = m_Records[index];
+        SoundDefinition definition;
+        definition.name = Name(index);
+        definition.defaultVolumedB = record.DefaultVolumedB;
+        definition.minDistance = record.MinDistance;
+        definition.maxDistance = record.MaxDistance;
+        definition.priority = record.Priority;
+        definition.is3D = (record.Flags & Is3D) != 0;
+        definition.isLooping = (record.Flags & IsLooping) != 0;
+        definition.isStream = (record.Flags & IsStream) != 0;
+        definition.pinned = (record.Flags & Pinned) != 0;
+        return definition;
+    }
+}
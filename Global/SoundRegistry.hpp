@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    // Sound definitions persisted on disk, in two forms:
+    //  - a YAML manifest, written by hand or by tools:
+    //      Voxaudio.Sounds:
+    //        - Name: sfx/gun.wav
+    //          MaxDistance: 50
+    //          ...
+    //  - a compiled registry, a flat binary file read in place (memory-mapped), without any parsing.
+    //
+    // The compiled registry is a header, an array of fixed size records and a table of the names (not null terminated).
+    // Every offset is relative to the start of the file, every value is little endian.
+    namespace SoundRegistry
+    {
+        inline constexpr uint32_t Magic = 0x52535856; // "VXSR"
+        inline constexpr uint32_t Version = 1;
+
+        struct Header
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t Count;
+            uint32_t RecordsOffset;
+            uint32_t NamesOffset;
+            uint32_t NamesSize;
+        };
+
+        enum RecordFlag : uint32_t
+        {
+            Is3D = 1 << 0,
+            IsLooping = 1 << 1,
+            IsStream = 1 << 2,
+            Pinned = 1 << 3,
+        };
+
+        struct Record
+        {
+            uint32_t NameOffset;
+            uint32_t NameSize;
+            float DefaultVolumedB;
+            float MinDistance;
+            float MaxDistance;
+            float Priority;
+            uint32_t Flags;
+        };
+
+        static_assert(sizeof(Header) == 24 && sizeof(Record) == 28, "The registry layout is part of the file format.");
+
+        // Return false (and leave outDefinitions as it was) if the file can't be read or isn't a valid manifest.
+        bool LoadManifest(const std::filesystem::path& manifestPath, std::vector<SoundDefinition>& outDefinitions);
+        bool SaveManifest(const std::filesystem::path& manifestPath, std::span<const SoundDefinition> definitions);
+
+        bool Compile(std::span<const SoundDefinition> definitions, const std::filesystem::path& registryPath);
+
+        // A view over the bytes of a compiled registry, usually a MappedFile.
+        class View
+        {
+        public:
+            // Return false if the bytes aren't a valid registry of this version.
+            bool Open(std::span<const std::byte> bytes);
+
+            uint32_t Count() const { return m_Count; }
+            std::string_view Name(uint32_t index) const;
+            SoundDefinition Definition(uint32_t index) const;
+        private:
+            std::span<const std::byte> m_Bytes;
+            const Record* m_Records = nullptr;
+            uint32_t m_Count = 0;
+        };
+    }
+}
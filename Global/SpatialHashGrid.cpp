@@ -0,0 +1,141 @@
+#include "SpatialHashGrid.hpp"
+#include <algorithm>
+
+namespace Voxymore::Audio
+{
+    SpatialHashGrid::SpatialHashGrid(float cellSize)
+    {
+        SetCellSize(cellSize);
+    }
+
+    void SpatialHashGrid::SetCapacity(uint32_t capacity)
+    {
+        // At most one cell per element, at least half of the table stays free so the probes are short.
+        uint32_t cellCount = 16;
+        while (cellCount < capacity * 2ull) cellCount *= 2;
+
+        m_Cells.assign(cellCount, Cell{});
+        m_CellMask = cellCount - 1;
+        m_Ids.assign(capacity, NullId);
+        m_Next.assign(capacity, InvalidIndex);
+        m_Previous.assign(capacity, InvalidIndex);
+        m_Slots.clear();
+        m_Slots.reserve(capacity);
+        m_SlotIndices.assign(capacity, InvalidIndex);
+        m_Count = 0;
+    }
+
+    void SpatialHashGrid::SetCellSize(float cellSize)
+    {
+        Clear();
+        m_CellSize = cellSize > 0.0f ? cellSize : 1.0f;
+        m_InvCellSize = 1.0f / m_CellSize;
+    }
+
+    void SpatialHashGrid::Insert(TypeId id, const Vector3& position)
+    {
+        uint32_t slot = SlotHandle::Index(id);
+        if(slot >= m_Ids.size() || m_Ids[slot] != NullId) return;
+
+        uint64_t key = Key(ToCell(position));
+        uint32_t index = Home(key);
+        while (m_Cells[index].Head != InvalidIndex && m_Cells[index].Key != key)
+        {
+            index = (index + 1) & m_CellMask;
+        }
+
+        Cell& cell = m_Cells[index];
+        cell.Key = key;
+        m_Ids[slot] = id;
+        m_Previous[slot] = InvalidIndex;
+        m_Next[slot] = cell.Head;
+        if(cell.Head != InvalidIndex) m_Previous[cell.Head] = slot;
+        cell.Head = slot;
+        m_SlotIndices[slot] = static_cast<uint32_t>(m_Slots.size());
+        m_Slots.push_back(slot);
+        ++m_Count;
+    }
+
+    void SpatialHashGrid::Remove(TypeId id, const Vector3& position)
+    {
+        uint32_t slot = SlotHandle::Index(id);
+        if(slot >= m_Ids.size() || m_Ids[slot] != id) return;
+
+        uint32_t previous = m_Previous[slot];
+        uint32_t next = m_Next[slot];
+        if(previous == InvalidIndex)
+        {
+            // The head of its cell, the position tells which one.
+            uint32_t cell = FindCell(Key(ToCell(position)));
+            if(cell == InvalidIndex || m_Cells[cell].Head != slot) return;
+            m_Cells[cell].Head = next;
+            if(next == InvalidIndex) EraseCell(cell);
+        }
+        else
+        {
+            m_Next[previous] = next;
+        }
+        if(next != InvalidIndex) m_Previous[next] = previous;
+
+        uint32_t last = m_Slots.back();
+        m_Slots[m_SlotIndices[slot]] = last;
+        m_SlotIndices[last] = m_SlotIndices[slot];
+        m_Slots.pop_back();
+        m_SlotIndices[slot] = InvalidIndex;
+
+        m_Ids[slot] = NullId;
+        --m_Count;
+    }
+
+    void SpatialHashGrid::Move(TypeId id, const Vector3& from, const Vector3& to)
+    {
+        uint64_t fromKey = Key(ToCell(from));
+        uint64_t toKey = Key(ToCell(to));
+        if(fromKey == toKey) return;
+
+        Remove(id, from);
+        Insert(id, to);
+    }
+
+    void SpatialHashGrid::Clear()
+    {
+        std::fill(m_Cells.begin(), m_Cells.end(), Cell{});
+        std::fill(m_Ids.begin(), m_Ids.end(), NullId);
+        m_Slots.clear();
+        m_Count = 0;
+    }
+
+    void SpatialHashGrid::EraseCell(uint32_t index)
+    {
+        uint32_t hole = index;
+        for (uint32_t next = (hole + 1) & m_CellMask; m_Cells[next].Head != InvalidIndex; next = (next + 1) & m_CellMask)
+        {
+            // The entry can fill the hole only if its home is not between the hole and itself.
+            uint32_t home = Home(m_Cells[next].Key);
+            if(((next - home) & m_CellMask) >= ((next - hole) & m_CellMask))
+            {
+                m_Cells[hole] = m_Cells[next];
+                hole = next;
+            }
+        }
+        m_Cells[hole] = Cell{};
+    }
+
+    SpatialHashGrid::CellCoord SpatialHashGrid::ToCell(const Vector3& position) const
+    {
+        return {
+            static_cast<int32_t>(std::floor(position.x * m_InvCellSize)),
+            static_cast<int32_t>(std::floor(position.y * m_InvCellSize)),
+            static_cast<int32_t>(std::floor(position.z * m_InvCellSize)),
+        };
+    }
+
+    uint64_t SpatialHashGrid::Key(const CellCoord& cell)
+    {
+        // 21 bits per axis, enough for ±1 million cells.
+        constexpr uint64_t mask = (1ull << 21) - 1ull;
+        return ((static_cast<uint64_t>(cell.x) & mask) << 42)
+             | ((static_cast<uint64_t>(cell.y) & mask) << 21)
+             |  (static_cast<uint64_t>(cell.z) & mask);
+    }
+}
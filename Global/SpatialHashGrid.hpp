@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include "SlotMap.hpp"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    // Uniform grid of infinite size where only the non-empty cells are stored (hashed by their coordinates).
+    // The elements are identified by their TypeId, the grid doesn't store the positions,
+    // so the caller gives back the old position when removing or moving an element.
+    //
+    // Nothing is allocated once the capacity is set: the elements of a cell are linked through arrays indexed by
+    // the slot of their handle, and the cells live in an open addressing table with room for one cell per element.
+    class SpatialHashGrid
+    {
+    public:
+        explicit SpatialHashGrid(float cellSize = 32.0f);
+
+        // Must be called before any element is inserted, the slot index of the handles must be lower than capacity.
+        void SetCapacity(uint32_t capacity);
+        void SetCellSize(float cellSize);
+        float GetCellSize() const { return m_CellSize; }
+
+        void Insert(TypeId id, const Vector3& position);
+        void Remove(TypeId id, const Vector3& position);
+        // Only touch the cells when the element changes of cell.
+        void Move(TypeId id, const Vector3& from, const Vector3& to);
+        void Clear();
+
+        size_t Size() const { return m_Count; }
+
+        // Call func(TypeId) for every element in a cell overlapping the sphere.
+        // Elements may be outside the sphere, the caller does the exact test.
+        // When the sphere covers more cells than there are elements, every element is given instead of probing the cells.
+        template<typename Func>
+        void QuerySphere(const Vector3& center, float radius, Func&& func) const
+        {
+            if(m_Count == 0) return;
+
+            // In double, a large radius doesn't fit the cell coordinates.
+            double cellsPerAxis = 2.0 * static_cast<double>(radius) * static_cast<double>(m_InvCellSize) + 1.0;
+            if(cellsPerAxis * cellsPerAxis * cellsPerAxis > static_cast<double>(m_Count))
+            {
+                for (uint32_t slot : m_Slots)
+                {
+                    func(m_Ids[slot]);
+                }
+                return;
+            }
+
+            CellCoord min = ToCell({center.x - radius, center.y - radius, center.z - radius});
+            CellCoord max = ToCell({center.x + radius, center.y + radius, center.z + radius});
+            float radiusSq = radius * radius;
+
+            for (int32_t x = min.x; x <= max.x; ++x)
+            {
+                float dx = AxisDistance(center.x, x);
+                for (int32_t y = min.y; y <= max.y; ++y)
+                {
+                    float dy = AxisDistance(center.y, y);
+                    if(dx * dx + dy * dy > radiusSq) continue;
+                    for (int32_t z = min.z; z <= max.z; ++z)
+                    {
+                        float dz = AxisDistance(center.z, z);
+                        if(dx * dx + dy * dy + dz * dz > radiusSq) continue;
+
+                        uint32_t cell = FindCell(Key({x, y, z}));
+                        if(cell == InvalidIndex) continue;
+                        for (uint32_t slot = m_Cells[cell].Head; slot != InvalidIndex; slot = m_Next[slot])
+                        {
+                            func(m_Ids[slot]);
+                        }
+                    }
+                }
+            }
+        }
+    private:
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+        struct CellCoord { int32_t x, y, z; };
+
+        // A free entry of the table has no head.
+        struct Cell
+        {
+            uint64_t Key = 0;
+            uint32_t Head = InvalidIndex;
+        };
+
+        CellCoord ToCell(const Vector3& position) const;
+        static uint64_t Key(const CellCoord& cell);
+        uint32_t Home(uint64_t key) const { return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & m_CellMask; }
+        // Index of the cell in the table, InvalidIndex if it is empty.
+        uint32_t FindCell(uint64_t key) const
+        {
+            if(m_Cells.empty()) return InvalidIndex;
+            for (uint32_t index = Home(key); m_Cells[index].Head != InvalidIndex; index = (index + 1) & m_CellMask)
+            {
+                if(m_Cells[index].Key == key) return index;
+            }
+            return InvalidIndex;
+        }
+        // Free an entry of the table, shifting back the entries of the following cluster so the probing stays valid.
+        void EraseCell(uint32_t index);
+
+        // Distance along one axis between a coordinate and the closest point of a cell.
+        float AxisDistance(float value, int32_t cell) const
+        {
+            float min = static_cast<float>(cell) * m_CellSize;
+            float max = min + m_CellSize;
+            if(value < min) return min - value;
+            if(value > max) return value - max;
+            return 0.0f;
+        }
+    private:
+        std::vector<Cell> m_Cells;
+        uint32_t m_CellMask = 0;
+        // Indexed by the slot of the handles, NullId when the slot is not in the grid.
+        std::vector<TypeId> m_Ids;
+        std::vector<uint32_t> m_Next;
+        std::vector<uint32_t> m_Previous;
+        // The slots in the grid, swap removed, and the index of each slot in it.
+        std::vector<uint32_t> m_Slots;
+        std::vector<uint32_t> m_SlotIndices;
+        float m_CellSize;
+        float m_InvCellSize;
+        size_t m_Count = 0;
+    };
+}
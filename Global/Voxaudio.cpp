@@ -0,0 +1,388 @@
+//
+// Created by ianpo on 04/11/2023.
+//
+
+#include "Voxaudio.hpp"
+#include "AudioEngine.hpp"
+#include "MappedFile.hpp"
+#include "SimdKernels.hpp"
+#include "SoundRegistry.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace Voxymore::Audio
+{
+    AudioEngine* s_Engine = nullptr;
+
+    // Split [0, count) in batches, call fill(ChannelBatch&, first, size) to copy the channels of each one
+    // and submit a copy of the command carrying the batch.
+    template<typename Func>
+    static void SubmitBulk(size_t count, const EngineCommand& command, Func&& fill)
+    {
+        for (size_t first = 0; first < count; first += ChannelBatch::Capacity)
+        {
+            size_t batchSize = std::min<size_t>(count - first, ChannelBatch::Capacity);
+            ChannelBatch* batch = s_Engine->NewChannelBatch();
+            batch->Count = static_cast<uint32_t>(batchSize);
+            fill(*batch, first, batchSize);
+
+            EngineCommand batchCommand = command;
+            batchCommand.Channels = batch;
+            s_Engine->Submit(batchCommand);
+        }
+    }
+
+    float Helper::dBToVolume(float dB)
+    {
+        return std::pow(10.0f, 0.05f * dB);
+    }
+
+    float Helper::VolumeTodB(float Volume)
+    {
+        return 20.0f * std::log10(Volume);
+    }
+
+    void Helper::dBToVolume(std::span<const float> decibels, std::span<float> outVolumes)
+    {
+        Simd::DecibelsToGains(decibels.data(), std::min(decibels.size(), outVolumes.size()), outVolumes.data());
+    }
+
+    void Helper::VolumeTodB(std::span<const float> volumes, std::span<float> outDecibels)
+    {
+        Simd::GainsToDecibels(volumes.data(), std::min(volumes.size(), outDecibels.size()), outDecibels.data());
+    }
+
+    void Voxaudio::Init(const std::filesystem::path& configFile, const MemorySetup& memory)
+    {
+        s_Engine = new AudioEngine(configFile, memory);
+    }
+
+    void Voxaudio::Update(float deltaTimeSeconds)
+    {
+        s_Engine->Update(deltaTimeSeconds);
+    }
+
+    void Voxaudio::Shutdown()
+    {
+        delete s_Engine;
+        s_Engine = nullptr;
+    }
+
+    TypeId Voxaudio::RegisterSound(const SoundDefinition& soundDef, bool load)
+    {
+        TypeId soundId = s_Engine->AcquireSoundId();
+        if(soundId == NullId) return soundId;
+
+        EngineCommand command{CommandType::RegisterSound};
+        command.Flags = load ? EngineCommand::Load : EngineCommand::None;
+        command.Id = soundId;
+        command.Definition = s_Engine->NewSoundDefinition(soundDef);
+        s_Engine->Submit(command);
+        return soundId;
+    }
+
+    // Acquire the ids of a batch and submit it, the ids that couldn't be acquired are removed from the batch.
+    static void SubmitRegistrationBatch(SoundRegistrationBatch* batch, bool load)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < batch->Definitions.size(); ++i)
+        {
+            if(batch->Ids[i] == NullId) continue;
+            if(kept != i)
+            {
+                batch->Ids[kept] = batch->Ids[i];
+                batch->Definitions[kept] = std::move(batch->Definitions[i]);
+            }
+            ++kept;
+        }
+        batch->Ids.resize(kept);
+        batch->Definitions.resize(kept);
+
+        EngineCommand command{CommandType::RegisterSounds};
+        command.Flags = load ? EngineCommand::Load : EngineCommand::None;
+        command.Priority = LoadPriority::Background;
+        command.Batch = batch;
+        s_Engine->Submit(command);
+    }
+
+    void Voxaudio::RegisterSounds(std::span<const SoundDefinition> soundDefs, std::span<TypeId> outSoundIds, bool load)
+    {
+        size_t count = std::min(soundDefs.size(), outSoundIds.size());
+        auto* batch = new SoundRegistrationBatch();
+        batch->Ids.resize(count);
+        batch->Definitions.assign(soundDefs.begin(), soundDefs.begin() + static_cast<std::ptrdiff_t>(count));
+        for (size_t i = 0; i < count; ++i)
+        {
+            outSoundIds[i] = batch->Ids[i] = s_Engine->AcquireSoundId();
+        }
+        SubmitRegistrationBatch(batch, load);
+    }
+
+    std::vector<TypeId> Voxaudio::RegisterSoundManifest(const std::filesystem::path& manifestPath, bool load)
+    {
+        auto* batch = new SoundRegistrationBatch();
+        if(!SoundRegistry::LoadManifest(manifestPath, batch->Definitions))
+        {
+            delete batch;
+            return {};
+        }
+
+        batch->Ids.resize(batch->Definitions.size());
+        for (TypeId& soundId : batch->Ids) soundId = s_Engine->AcquireSoundId();
+        std::vector<TypeId> soundIds = batch->Ids;
+        SubmitRegistrationBatch(batch, load);
+        return soundIds;
+    }
+
+    bool Voxaudio::SaveSoundManifest(const std::filesystem::path& manifestPath, std::span<const SoundDefinition> soundDefs)
+    {
+        return SoundRegistry::SaveManifest(manifestPath, soundDefs);
+    }
+
+    bool Voxaudio::CompileSoundManifest(const std::filesystem::path& manifestPath, const std::filesystem::path& registryPath)
+    {
+        std::vector<SoundDefinition> definitions;
+        if(!SoundRegistry::LoadManifest(manifestPath, definitions)) return false;
+        return SoundRegistry::Compile(definitions, registryPath);
+    }
+
+    std::vector<TypeId> Voxaudio::RegisterSoundRegistry(const std::filesystem::path& registryPath, bool load)
+    {
+        MappedFile file;
+        SoundRegistry::View registry;
+        if(!file.Open(registryPath) || !registry.Open(file.Bytes())) return {};
+
+        auto* batch = new SoundRegistrationBatch();
+        batch->Ids.resize(registry.Count());
+        batch->Definitions.resize(registry.Count());
+        for (uint32_t i = 0; i < registry.Count(); ++i)
+        {
+            batch->Definitions[i] = registry.Definition(i);
+            batch->Ids[i] = s_Engine->AcquireSoundId();
+        }
+
+        std::vector<TypeId> soundIds = batch->Ids;
+        SubmitRegistrationBatch(batch, load);
+        return soundIds;
+    }
+
+    bool Voxaudio::BuildSoundPack(std::span<const std::filesystem::path> files, const std::filesystem::path& root, const std::filesystem::path& packPath)
+    {
+        return SoundPack::Build(files, root, packPath);
+    }
+
+    bool Voxaudio::MountSoundPack(const std::filesystem::path& packPath)
+    {
+        auto* pack = new SoundPack();
+        if(!pack->Open(packPath))
+        {
+            delete pack;
+            return false;
+        }
+
+        EngineCommand command{CommandType::MountSoundPack};
+        command.Pack = pack;
+        s_Engine->Submit(command);
+        return true;
+    }
+
+    void Voxaudio::UnregisterSound(TypeId soundId)
+    {
+        EngineCommand command{CommandType::UnregisterSound};
+        command.Id = soundId;
+        s_Engine->Submit(command);
+    }
+
+    void Voxaudio::LoadSound(TypeId soundId, LoadPriority priority)
+    {
+        EngineCommand command{CommandType::LoadSound};
+        command.Id = soundId;
+        command.Priority = priority;
+        s_Engine->Submit(command);
+    }
+
+    void Voxaudio::UnloadSound(TypeId soundId)
+    {
+        EngineCommand command{CommandType::UnloadSound};
+        command.Id = soundId;
+        s_Engine->Submit(command);
+    }
+
+    void Voxaudio::Set3dListenerAndOrientation(const Vector3& position, const Vector3& look, const Vector3& up)
+    {
+        EngineCommand command{CommandType::SetListener};
+        command.Position = position;
+        command.Look = look;
+        command.Up = up;
+        s_Engine->Submit(command);
+    }
+
+    void Voxaudio::Set3dListenerAndOrientation(const Vector3& position, const Vector3& look, const Vector3& up, const Vector3& velocity)
+    {
+        EngineCommand command{CommandType::SetListener};
+        command.Flags = EngineCommand::HasVelocity;
+        command.Position = position;
+        command.Look = look;
+        command.Up = up;
+        command.Velocity = velocity;
+        s_Engine->Submit(command);
+    }
+
+    TypeId Voxaudio::PlaySound(TypeId soundId, const Vector3& pos, float volumedB)
+    {
+        TypeId channelId = s_Engine->AcquireChannelId();
+        if(channelId == NullId) return channelId;
+
+        EngineCommand command{CommandType::PlaySound};
+        command.Id = channelId;
+        command.SoundId = soundId;
+        command.Position = pos;
+        command.Value = volumedB;
+        command.RequestTime = std::chrono::steady_clock::now();
+        s_Engine->Submit(command);
+        return channelId;
+    }
+
+    TypeId Voxaudio::PlaySoundAt(TypeId soundId, uint64_t dspClock, const Vector3& pos, float volumedB)
+    {
+        TypeId channelId = s_Engine->AcquireChannelId();
+        if(channelId == NullId) return channelId;
+
+        EngineCommand command{CommandType::PlaySound};
+        command.Id = channelId;
+        command.SoundId = soundId;
+        command.Position = pos;
+        command.Value = volumedB;
+        command.StartClock = dspClock;
+        s_Engine->Submit(command);
+        return channelId;
+    }
+
+    void Voxaudio::StopChannel(TypeId channelId, float fadeTimeSeconds, FadeShape fadeShape)
+    {
+        EngineCommand command{CommandType::StopChannel};
+        command.Id = channelId;
+        command.Value = fadeTimeSeconds;
+        command.Shape = fadeShape;
+        s_Engine->Submit(command);
+    }
+
+    void Voxaudio::StopAllChannels()
+    {
+        s_Engine->Submit(EngineCommand{CommandType::StopAllChannels});
+    }
+
+    void Voxaudio::SetChannel3dPosition(TypeId channelId, const Vector3& position)
+    {
+        EngineCommand command{CommandType::SetChannelPosition};
+        command.Id = channelId;
+        command.Position = position;
+        s_Engine->Submit(command);
+    }
+
+    void Voxaudio::SetChannelVolume(TypeId channelId, float volumedB)
+    {
+        EngineCommand command{CommandType::SetChannelVolume};
+        command.Id = channelId;
+        command.Value = volumedB;
+        s_Engine->Submit(command);
+    }
+
+    void Voxaudio::PlaySounds(std::span<const TypeId> soundIds, std::span<const Vector3> positions, std::span<const float> volumesdB, std::span<TypeId> outChannelIds)
+    {
+        size_t count = std::min({soundIds.size(), positions.size(), outChannelIds.size()});
+        if(!volumesdB.empty()) count = std::min(count, volumesdB.size());
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            outChannelIds[i] = s_Engine->AcquireChannelId();
+        }
+
+        EngineCommand command{CommandType::PlaySounds};
+        command.RequestTime = std::chrono::steady_clock::now();
+        SubmitBulk(count, command, [&](ChannelBatch& batch, size_t first, size_t size)
+        {
+            // A full channel table gives NullId, the engine ignores the channel.
+            std::copy_n(outChannelIds.data() + first, size, batch.Ids.data());
+            std::copy_n(soundIds.data() + first, size, batch.SoundIds.data());
+            std::copy_n(positions.data() + first, size, batch.Positions.data());
+            if(volumesdB.empty()) std::fill_n(batch.Values.data(), size, 0.0f);
+            else std::copy_n(volumesdB.data() + first, size, batch.Values.data());
+        });
+    }
+
+    void Voxaudio::StopChannels(std::span<const TypeId> channelIds, float fadeTimeSeconds, FadeShape fadeShape)
+    {
+        EngineCommand command{CommandType::StopChannels};
+        command.Value = fadeTimeSeconds;
+        command.Shape = fadeShape;
+        SubmitBulk(channelIds.size(), command, [&](ChannelBatch& batch, size_t first, size_t size)
+        {
+            std::copy_n(channelIds.data() + first, size, batch.Ids.data());
+        });
+    }
+
+    void Voxaudio::SetChannel3dPositions(std::span<const TypeId> channelIds, std::span<const Vector3> positions)
+    {
+        SubmitBulk(std::min(channelIds.size(), positions.size()), EngineCommand{CommandType::SetChannelPositions}, [&](ChannelBatch& batch, size_t first, size_t size)
+        {
+            std::copy_n(channelIds.data() + first, size, batch.Ids.data());
+            std::copy_n(positions.data() + first, size, batch.Positions.data());
+        });
+    }
+
+    void Voxaudio::SetChannelVolumes(std::span<const TypeId> channelIds, std::span<const float> volumesdB)
+    {
+        SubmitBulk(std::min(channelIds.size(), volumesdB.size()), EngineCommand{CommandType::SetChannelVolumes}, [&](ChannelBatch& batch, size_t first, size_t size)
+        {
+            std::copy_n(channelIds.data() + first, size, batch.Ids.data());
+            std::copy_n(volumesdB.data() + first, size, batch.Values.data());
+        });
+    }
+
+    bool Voxaudio::IsPlaying(TypeId channelId)
+    {
+        return s_Engine->IsPlaying(channelId);
+    }
+
+    EngineStats Voxaudio::GetStats()
+    {
+        return s_Engine->GetStats();
+    }
+
+    uint64_t Voxaudio::GetDspClock()
+    {
+        return s_Engine->GetDspClock();
+    }
+
+    int Voxaudio::GetSampleRate()
+    {
+        return s_Engine->GetSampleRate();
+    }
+
+    OneShotSound Voxaudio::PlayOnShot(const SoundDefinition &soundDef, const Vector3& pos, float volumedB)
+    {
+        TypeId soundId = s_Engine->AcquireOneShotSound(soundDef);
+        if(soundId == NullId) return {NullId, NullId};
+
+        TypeId channelId = s_Engine->AcquireChannelId();
+        if(channelId == NullId)
+        {
+            s_Engine->ReleaseOneShotSound(soundId);
+            return {soundId, channelId};
+        }
+
+        EngineCommand command{CommandType::PlaySound};
+        command.Flags = EngineCommand::OneShot;
+        command.Id = channelId;
+        command.SoundId = soundId;
+        command.Position = pos;
+        command.Value = volumedB;
+        command.RequestTime = std::chrono::steady_clock::now();
+        s_Engine->Submit(command);
+        return {soundId, channelId};
+    }
+}
@@ -0,0 +1,330 @@
+#define MINIAUDIO_IMPLEMENTATION
+#include "MiniaudioBackend.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// Count the miniaudio calls of the frame, the expression keeps the value of the call.
+#define CountMiniaudio(func) (++m_CallCount, func)
+// Size of the header put in front of every miniaudio allocation, keeps the alignment of malloc.
+#define ALLOCATION_HEADER_SIZE alignof(std::max_align_t)
+// A stream keeps two pages of decoded samples, a page is a second of audio by default.
+#define STREAM_RESIDENT_SECONDS 2
+
+namespace Voxymore::Audio
+{
+    // Indexed by SpeakerMode, 0 lets miniaudio use the channels of the device. There is no raw mode.
+    static const std::array<ma_uint32, 9> s_SpeakerModeChannels = {0, 0, 1, 2, 4, 5, 6, 8, 12};
+
+    MiniaudioBackend::MiniaudioBackend(const EngineConfig& config, const MemorySetup& memory) : m_Memory(memory)
+    {
+        if(m_Memory.block) std::cerr << "Voxaudio ERROR : miniaudio can't allocate from a fixed block, the heap is used." << std::endl;
+
+        ma_engine_config engineConfig = ma_engine_config_init();
+        engineConfig.allocationCallbacks.pUserData = this;
+        engineConfig.allocationCallbacks.onMalloc = &MiniaudioBackend::Allocate;
+        engineConfig.allocationCallbacks.onRealloc = &MiniaudioBackend::Reallocate;
+        engineConfig.allocationCallbacks.onFree = &MiniaudioBackend::Free;
+        engineConfig.channels = s_SpeakerModeChannels[static_cast<size_t>(config.speakerMode)];
+        engineConfig.sampleRate = static_cast<ma_uint32>(std::max(config.sampleRate, 0));
+        engineConfig.periodSizeInFrames = config.dspBufferLength;
+
+        m_NonRealTime = config.IsNonRealTime();
+        if(m_NonRealTime)
+        {
+            // Without device the engine only mixes when it is read, the format has to be given.
+            engineConfig.noDevice = MA_TRUE;
+            if(engineConfig.channels == 0) engineConfig.channels = 2;
+            if(engineConfig.sampleRate == 0) engineConfig.sampleRate = 48000;
+            if(config.dspBufferLength > 0) m_MixFrames = config.dspBufferLength;
+        }
+        CheckMiniaudio(ma_engine_init(&engineConfig, &m_Engine));
+
+        ma_uint32 channels = ma_engine_get_channels(&m_Engine);
+        if(m_NonRealTime)
+        {
+            m_MixBuffer.resize(static_cast<size_t>(m_MixFrames) * channels);
+            if(config.outputMode == OutputMode::WavWriterNrt)
+            {
+                ma_encoder_config encoderConfig = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, channels, ma_engine_get_sample_rate(&m_Engine));
+                ma_result result = ma_encoder_init_file(config.wavWriterPath.c_str(), &encoderConfig, &m_Encoder);
+                CheckMiniaudio(result);
+                m_HasEncoder = result == MA_SUCCESS;
+            }
+        }
+        else if(ma_device* device = ma_engine_get_device(&m_Engine))
+        {
+            // The periods miniaudio really uses, the device may not give the asked size.
+            m_OutputLatencyMs = 1000.0f * static_cast<float>(device->playback.internalPeriodSizeInFrames) * static_cast<float>(device->playback.internalPeriods)
+                    / static_cast<float>(device->playback.internalSampleRate);
+        }
+
+        m_Voices.SetCapacity(static_cast<uint32_t>(std::max(config.numberOfChannels, 1)));
+        m_FadingVoices.reserve(static_cast<size_t>(std::max(config.numberOfChannels, 1)));
+    }
+
+    MiniaudioBackend::~MiniaudioBackend()
+    {
+        ma_engine_uninit(&m_Engine);
+        if(m_HasEncoder) ma_encoder_uninit(&m_Encoder);
+    }
+
+    void MiniaudioBackend::Update()
+    {
+        uint64_t clock = GetDspClock();
+        for (size_t i = 0; i < m_FadingVoices.size();)
+        {
+            MiniaudioVoice& voice = *m_FadingVoices[i];
+            if(RampToNextFadePoint(voice, clock)) ++i;
+            else RemoveFadingVoice(voice);
+        }
+
+        if(!m_NonRealTime) return;
+
+        // Without real time each update mixes one buffer, the engine clock moves with it.
+        ma_uint64 framesRead = 0;
+        CheckMiniaudio(CountMiniaudio(ma_engine_read_pcm_frames(&m_Engine, m_MixBuffer.data(), m_MixFrames, &framesRead)));
+        if(m_HasEncoder) CheckMiniaudio(ma_encoder_write_pcm_frames(&m_Encoder, m_MixBuffer.data(), framesRead, nullptr));
+    }
+
+    void MiniaudioBackend::SetListener(const Vector3& position, const Vector3* velocity, const Vector3& look, const Vector3& up)
+    {
+        //TODO: Add a multi-listener system.
+        CountMiniaudio(ma_engine_listener_set_position(&m_Engine, 0, position.x, position.y, position.z));
+        CountMiniaudio(ma_engine_listener_set_direction(&m_Engine, 0, look.x, look.y, look.z));
+        CountMiniaudio(ma_engine_listener_set_world_up(&m_Engine, 0, up.x, up.y, up.z));
+        if(velocity) CountMiniaudio(ma_engine_listener_set_velocity(&m_Engine, 0, velocity->x, velocity->y, velocity->z));
+    }
+
+    uint32_t MiniaudioBackend::ConsumeCallCount()
+    {
+        uint32_t count = m_CallCount;
+        m_CallCount = 0;
+        return count;
+    }
+
+    MemoryStats MiniaudioBackend::GetMemoryStats()
+    {
+        return {m_MemoryUsed.load(std::memory_order_relaxed), m_MemoryPeak.load(std::memory_order_relaxed), 0};
+    }
+
+    MiniaudioBackend::SoundHandle MiniaudioBackend::CreateSound(const SoundDefinition& definition, [[maybe_unused]] LoadPriority priority, std::span<const std::byte> packEntry, bool blocking)
+    {
+        auto* sound = new MiniaudioSound();
+        sound->Name = definition.name;
+        sound->IsStream = definition.isStream;
+        sound->IsLooping = definition.isLooping;
+        sound->MinDistance = definition.minDistance;
+        sound->MaxDistance = definition.maxDistance;
+        sound->VoiceFlags = definition.is3D ? 0 : MA_SOUND_FLAG_NO_SPATIALIZATION;
+        if(definition.isStream) sound->VoiceFlags |= MA_SOUND_FLAG_STREAM | (blocking ? 0 : MA_SOUND_FLAG_ASYNC);
+
+        if(!packEntry.empty())
+        {
+            // The resource manager decodes the mapped pack in place, the data is never copied.
+            // It only reads the data even though it takes a non const pointer.
+            void* data = const_cast<std::byte*>(packEntry.data());
+            ma_result result = CountMiniaudio(ma_resource_manager_register_encoded_data(ma_engine_get_resource_manager(&m_Engine), sound->Name.c_str(), data, packEntry.size()));
+            CheckMiniaudio(result);
+            sound->FromPack = result == MA_SUCCESS;
+        }
+
+        // The prototype is never played, it stays out of the node graph.
+        ma_uint32 flags = MA_SOUND_FLAG_NO_DEFAULT_ATTACHMENT;
+        flags |= definition.isStream ? MA_SOUND_FLAG_STREAM : MA_SOUND_FLAG_DECODE;
+        if(!blocking) flags |= MA_SOUND_FLAG_ASYNC;
+        ma_result result = CountMiniaudio(ma_sound_init_from_file(&m_Engine, sound->Name.c_str(), flags, nullptr, nullptr, &sound->Prototype));
+        CheckMiniaudio(result);
+        if(result != MA_SUCCESS)
+        {
+            if(sound->FromPack) ma_resource_manager_unregister_data(ma_engine_get_resource_manager(&m_Engine), sound->Name.c_str());
+            delete sound;
+            return nullptr;
+        }
+        return sound;
+    }
+
+    BackendLoadState MiniaudioBackend::GetLoadState(SoundHandle sound)
+    {
+        ma_result result = CountMiniaudio(ma_resource_manager_data_source_result(sound->Prototype.pResourceManagerDataSource));
+        if(result == MA_BUSY) return BackendLoadState::Loading;
+        return result == MA_SUCCESS ? BackendLoadState::Ready : BackendLoadState::Error;
+    }
+
+    uint64_t MiniaudioBackend::FinishLoad(SoundHandle sound, [[maybe_unused]] const SoundDefinition& definition)
+    {
+        ma_format format = ma_format_unknown;
+        ma_uint32 channels = 0;
+        ma_uint32 sampleRate = 0;
+        CheckMiniaudio(CountMiniaudio(ma_sound_get_data_format(&sound->Prototype, &format, &channels, &sampleRate, nullptr, 0)));
+        uint64_t frameBytes = static_cast<uint64_t>(channels) * ma_get_bytes_per_sample(format);
+        if(sound->IsStream) return STREAM_RESIDENT_SECONDS * static_cast<uint64_t>(sampleRate) * frameBytes;
+
+        // The samples are kept decoded.
+        ma_uint64 frames = 0;
+        CheckMiniaudio(CountMiniaudio(ma_sound_get_length_in_pcm_frames(&sound->Prototype, &frames)));
+        return frames * frameBytes;
+    }
+
+    void MiniaudioBackend::ReleaseSound(SoundHandle sound)
+    {
+        CountMiniaudio(ma_sound_uninit(&sound->Prototype));
+        if(sound->FromPack) CountMiniaudio(ma_resource_manager_unregister_data(ma_engine_get_resource_manager(&m_Engine), sound->Name.c_str()));
+        delete sound;
+    }
+
+    MiniaudioBackend::VoiceHandle MiniaudioBackend::StartVoice(SoundHandle sound, uint64_t startClock)
+    {
+        MiniaudioVoice* voice = m_Voices.New();
+        ma_result result = sound->IsStream
+                ? CountMiniaudio(ma_sound_init_from_file(&m_Engine, sound->Name.c_str(), sound->VoiceFlags, nullptr, nullptr, &voice->Sound))
+                : CountMiniaudio(ma_sound_init_copy(&m_Engine, &sound->Prototype, sound->VoiceFlags, nullptr, &voice->Sound));
+        if(result != MA_SUCCESS)
+        {
+            m_Voices.Delete(voice);
+            return nullptr;
+        }
+
+        ma_sound* maSound = &voice->Sound;
+        CountMiniaudio(ma_sound_set_looping(maSound, sound->IsLooping ? MA_TRUE : MA_FALSE));
+        if((sound->VoiceFlags & MA_SOUND_FLAG_NO_SPATIALIZATION) == 0)
+        {
+            // The closest model of miniaudio to the inverse tapered rolloff of FMOD, it isn't silent at the max distance.
+            CountMiniaudio(ma_sound_set_attenuation_model(maSound, ma_attenuation_model_inverse));
+            CountMiniaudio(ma_sound_set_min_distance(maSound, sound->MinDistance));
+            CountMiniaudio(ma_sound_set_max_distance(maSound, sound->MaxDistance));
+        }
+        // The voice stays stopped until it is unpaused, then waits for the engine time to reach its start.
+        if(startClock > 0) CountMiniaudio(ma_sound_set_start_time_in_pcm_frames(maSound, startClock));
+        return voice;
+    }
+
+    void MiniaudioBackend::StopVoice(VoiceHandle voice)
+    {
+        if(voice->FadingIndex != MiniaudioVoice::NotFading) RemoveFadingVoice(*voice);
+        CountMiniaudio(ma_sound_uninit(&voice->Sound));
+        m_Voices.Delete(voice);
+    }
+
+    bool MiniaudioBackend::IsVoicePlaying(VoiceHandle voice)
+    {
+        // A non looping sound stops itself at its end, until then it is playing even if it is paused or delayed.
+        return !CountMiniaudio(ma_sound_at_end(&voice->Sound));
+    }
+
+    void MiniaudioBackend::SetVoicePosition(VoiceHandle voice, const Vector3& position)
+    {
+        CountMiniaudio(ma_sound_set_position(&voice->Sound, position.x, position.y, position.z));
+    }
+
+    void MiniaudioBackend::SetVoiceVolume(VoiceHandle voice, float gain)
+    {
+        CountMiniaudio(ma_sound_set_volume(&voice->Sound, gain));
+    }
+
+    void MiniaudioBackend::SetVoicePaused(VoiceHandle voice, bool paused)
+    {
+        ma_result result = paused ? CountMiniaudio(ma_sound_stop(&voice->Sound)) : CountMiniaudio(ma_sound_start(&voice->Sound));
+        CheckMiniaudio(result);
+    }
+
+    void MiniaudioBackend::SetVoiceFadePoints(VoiceHandle voice, std::span<const FadePoint> points)
+    {
+        if(points.empty()) return;
+
+        // The last point is always kept, the envelope ends on its gain.
+        size_t count = std::min(points.size(), MiniaudioVoice::MaxFadePoints);
+        std::copy_n(points.begin(), count - 1, voice->FadePoints.begin());
+        voice->FadePoints[count - 1] = points.back();
+        voice->FadePointCount = static_cast<uint32_t>(count);
+        voice->NextFadePoint = 1;
+
+        // The first point is the gain now.
+        const FadePoint& first = voice->FadePoints[0];
+        const FadePoint& next = voice->FadePoints[std::min<size_t>(1, count - 1)];
+        uint64_t length = next.Clock > first.Clock ? next.Clock - first.Clock : 0;
+        CountMiniaudio(ma_sound_set_fade_in_pcm_frames(&voice->Sound, first.Gain, next.Gain, length));
+
+        if(count > 2 && voice->FadingIndex == MiniaudioVoice::NotFading)
+        {
+            voice->FadingIndex = static_cast<uint32_t>(m_FadingVoices.size());
+            m_FadingVoices.push_back(voice);
+        }
+        else if(count <= 2 && voice->FadingIndex != MiniaudioVoice::NotFading)
+        {
+            RemoveFadingVoice(*voice);
+        }
+    }
+
+    bool MiniaudioBackend::RampToNextFadePoint(MiniaudioVoice& voice, uint64_t clock)
+    {
+        uint32_t next = voice.NextFadePoint;
+        while (next < voice.FadePointCount && voice.FadePoints[next].Clock <= clock) ++next;
+        if(next == voice.NextFadePoint) return true;
+
+        voice.NextFadePoint = next;
+        if(next >= voice.FadePointCount)
+        {
+            // The segment toward the last point is already over.
+            CountMiniaudio(ma_sound_set_fade_in_pcm_frames(&voice.Sound, -1.0f, voice.FadePoints[voice.FadePointCount - 1].Gain, 0));
+            return false;
+        }
+
+        // -1 starts from the current volume of the fade, the segment is late by up to an update.
+        const FadePoint& target = voice.FadePoints[next];
+        CountMiniaudio(ma_sound_set_fade_in_pcm_frames(&voice.Sound, -1.0f, target.Gain, target.Clock - clock));
+        return true;
+    }
+
+    void MiniaudioBackend::RemoveFadingVoice(MiniaudioVoice& voice)
+    {
+        MiniaudioVoice* last = m_FadingVoices.back();
+        m_FadingVoices[voice.FadingIndex] = last;
+        last->FadingIndex = voice.FadingIndex;
+        m_FadingVoices.pop_back();
+        voice.FadingIndex = MiniaudioVoice::NotFading;
+    }
+
+    void* MiniaudioBackend::Allocate(size_t size, void* user)
+    {
+        auto* backend = static_cast<MiniaudioBackend*>(user);
+        const MemorySetup& memory = backend->m_Memory;
+        size_t total = size + ALLOCATION_HEADER_SIZE;
+        auto* block = static_cast<std::byte*>(memory.alloc ? memory.alloc(total, memory.user) : std::malloc(total));
+        if(!block) return nullptr;
+
+        std::memcpy(block, &size, sizeof(size_t));
+        uint64_t used = backend->m_MemoryUsed.fetch_add(size, std::memory_order_relaxed) + size;
+        uint64_t peak = backend->m_MemoryPeak.load(std::memory_order_relaxed);
+        while (used > peak && !backend->m_MemoryPeak.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {}
+        return block + ALLOCATION_HEADER_SIZE;
+    }
+
+    void* MiniaudioBackend::Reallocate(void* ptr, size_t size, void* user)
+    {
+        if(!ptr) return Allocate(size, user);
+
+        void* newPtr = Allocate(size, user);
+        if(!newPtr) return nullptr;
+
+        size_t oldSize;
+        std::memcpy(&oldSize, static_cast<std::byte*>(ptr) - ALLOCATION_HEADER_SIZE, sizeof(size_t));
+        std::memcpy(newPtr, ptr, std::min(oldSize, size));
+        Free(ptr, user);
+        return newPtr;
+    }
+
+    void MiniaudioBackend::Free(void* ptr, void* user)
+    {
+        if(!ptr) return;
+
+        auto* backend = static_cast<MiniaudioBackend*>(user);
+        const MemorySetup& memory = backend->m_Memory;
+        std::byte* block = static_cast<std::byte*>(ptr) - ALLOCATION_HEADER_SIZE;
+        size_t size;
+        std::memcpy(&size, block, sizeof(size_t));
+        backend->m_MemoryUsed.fetch_sub(size, std::memory_order_relaxed);
+        if(memory.free) memory.free(block, memory.user);
+        else std::free(block);
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include "EngineConfig.hpp"
+#include "BackendTypes.hpp"
+#include "FixedPool.hpp"
+#include "IoScheduler.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+#include <miniaudio.h>
+
+#define MiniaudioResult Combine(result , __LINE__)
+#define CheckMiniaudio(func) {ma_result MiniaudioResult = func; if(MiniaudioResult != MA_SUCCESS) {std::cerr << "miniaudio ERROR : " << ma_result_description(MiniaudioResult) << std::endl; VXM_BREAK;} }
+
+namespace Voxymore::Audio
+{
+    // A loaded sound. The samples are decoded once by the resource manager, each voice is a copy sharing the data.
+    // The streams can't share their decoder, their voices open the file again.
+    struct MiniaudioSound
+    {
+        ma_sound Prototype;
+        std::string Name;
+        // Flags given to the voices.
+        ma_uint32 VoiceFlags = 0;
+        bool IsStream = false;
+        bool IsLooping = false;
+        // Registered in the resource manager under Name, unregistered with the sound.
+        bool FromPack = false;
+        float MinDistance = 1.0f;
+        float MaxDistance = 10000.0f;
+    };
+
+    struct MiniaudioVoice
+    {
+        static constexpr size_t MaxFadePoints = 32;
+        static constexpr uint32_t NotFading = 0xFFFFFFFF;
+
+        ma_sound Sound;
+        // miniaudio fades a sound on a single linear segment, the update starts the segment toward the next point.
+        std::array<FadePoint, MaxFadePoints> FadePoints;
+        uint32_t FadePointCount = 0;
+        uint32_t NextFadePoint = 0;
+        // Index in MiniaudioBackend::m_FadingVoices.
+        uint32_t FadingIndex = NotFading;
+    };
+
+    // The miniaudio backend, see AudioBackendType for what each function does.
+    // It uses the high level engine of miniaudio: its node graph mixes and spatializes the voices,
+    // its resource manager decodes the sounds on its job thread.
+    class MiniaudioBackend
+    {
+    public:
+        typedef MiniaudioSound* SoundHandle;
+        typedef MiniaudioVoice* VoiceHandle;
+        static constexpr const char* ConfigSection = "Voxaudio.Miniaudio";
+
+        MiniaudioBackend(const EngineConfig& config, const MemorySetup& memory);
+        ~MiniaudioBackend();
+        MiniaudioBackend(const MiniaudioBackend&) = delete;
+        MiniaudioBackend& operator=(const MiniaudioBackend&) = delete;
+
+        int GetSampleRate() const { return static_cast<int>(ma_engine_get_sample_rate(&m_Engine)); }
+        float GetOutputLatencyMs() const { return m_OutputLatencyMs; }
+        // The engine time is read atomically by miniaudio, it can be asked from any thread.
+        uint64_t GetDspClock() const { return ma_engine_get_time_in_pcm_frames(&m_Engine); }
+
+        void Update();
+        void SetListener(const Vector3& position, const Vector3* velocity, const Vector3& look, const Vector3& up);
+        uint32_t ConsumeCallCount();
+        MemoryStats GetMemoryStats();
+        // miniaudio reads the files itself, there is no I/O to report.
+        IoStats ConsumeIoStats() { return {}; }
+
+        SoundHandle CreateSound(const SoundDefinition& definition, LoadPriority priority, std::span<const std::byte> packEntry, bool blocking);
+        BackendLoadState GetLoadState(SoundHandle sound);
+        uint64_t FinishLoad(SoundHandle sound, const SoundDefinition& definition);
+        void ReleaseSound(SoundHandle sound);
+
+        VoiceHandle StartVoice(SoundHandle sound, uint64_t startClock);
+        void StopVoice(VoiceHandle voice);
+        bool IsVoicePlaying(VoiceHandle voice);
+        void SetVoicePosition(VoiceHandle voice, const Vector3& position);
+        void SetVoiceVolume(VoiceHandle voice, float gain);
+        void SetVoicePaused(VoiceHandle voice, bool paused);
+        void SetVoiceFadePoints(VoiceHandle voice, std::span<const FadePoint> points);
+    private:
+        // Start the fade segment of the voice that contains the clock, return false once the envelope is over.
+        bool RampToNextFadePoint(MiniaudioVoice& voice, uint64_t clock);
+        void RemoveFadingVoice(MiniaudioVoice& voice);
+
+        // Every allocation of miniaudio has a header holding its size, so the memory it uses can be reported like FMOD does.
+        static void* Allocate(size_t size, void* user);
+        static void* Reallocate(void* ptr, size_t size, void* user);
+        static void Free(void* ptr, void* user);
+    private:
+        ma_engine m_Engine;
+        bool m_NonRealTime = false;
+        // Samples mixed by each update without real time, and where they go.
+        uint32_t m_MixFrames = 1024;
+        std::vector<float> m_MixBuffer;
+        ma_encoder m_Encoder;
+        bool m_HasEncoder = false;
+
+        float m_OutputLatencyMs = 0.0f;
+        uint32_t m_CallCount = 0;
+        MemorySetup m_Memory;
+        std::atomic<uint64_t> m_MemoryUsed = 0;
+        std::atomic<uint64_t> m_MemoryPeak = 0;
+
+        FixedPool<MiniaudioVoice> m_Voices;
+        // Voices with fade points left, the update moves them along their envelope.
+        std::vector<MiniaudioVoice*> m_FadingVoices;
+    };
+}
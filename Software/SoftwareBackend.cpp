@@ -0,0 +1,385 @@
+#include "SoftwareBackend.hpp"
+#include "SimdKernels.hpp"
+#include <algorithm>
+#include <iostream>
+#include <glm/glm.hpp>
+
+// Blocks the real time mode mixes in one update to catch up with the wall clock, beyond it the late audio is dropped.
+#define MAX_CATCH_UP_BLOCKS 8
+
+namespace Voxymore::Audio
+{
+    SoftwareBackend::SoftwareBackend(const EngineConfig& config, const MemorySetup& memory) : m_Scheduler(static_cast<uint32_t>(std::max(config.ioThreads, 1)))
+    {
+        if(memory.block || memory.alloc) std::cerr << "Voxaudio ERROR : The software backend allocates from the heap, the memory setup is ignored." << std::endl;
+        if(config.speakerMode != SpeakerMode::Default && config.speakerMode != SpeakerMode::Stereo) std::cerr << "Voxaudio ERROR : The software backend only mixes in stereo." << std::endl;
+
+        if(config.sampleRate > 0) m_SampleRate = static_cast<uint32_t>(config.sampleRate);
+        // 10 ms blocks by default.
+        m_BlockLength = config.dspBufferLength > 0 ? config.dspBufferLength : std::max(m_SampleRate / 100, 1u);
+        m_OutputMode = config.outputMode;
+        // The sink takes the block as soon as it is mixed, the only audio queued is the block itself.
+        if(!config.IsNonRealTime()) m_OutputLatencyMs = 1000.0f * static_cast<float>(m_BlockLength) / static_cast<float>(m_SampleRate);
+
+        m_Left.resize(m_BlockLength);
+        m_Right.resize(m_BlockLength);
+        m_Interleaved.resize(static_cast<size_t>(m_BlockLength) * 2);
+        if(config.outputMode == OutputMode::WavWriterNrt) m_WavWriter.Open(config.wavWriterPath, 2, m_SampleRate);
+
+        uint32_t capacity = static_cast<uint32_t>(std::max(config.numberOfChannels, 1));
+        m_Voices.SetCapacity(capacity);
+        m_ActiveVoices.reserve(capacity);
+        m_PositionsX.reserve(capacity);
+        m_PositionsY.reserve(capacity);
+        m_PositionsZ.reserve(capacity);
+        m_MinDistances.reserve(capacity);
+        m_MaxDistances.reserve(capacity);
+        m_LeftGains.reserve(capacity);
+        m_RightGains.reserve(capacity);
+
+        m_StartTime = std::chrono::steady_clock::now();
+    }
+
+    SoftwareBackend::~SoftwareBackend()
+    {
+        m_WavWriter.Close();
+    }
+
+    void SoftwareBackend::Update()
+    {
+        if(m_OutputMode != OutputMode::RealTime)
+        {
+            // Without real time each update mixes one block, the clock moves with it.
+            MixBlock();
+            return;
+        }
+
+        // Mix the blocks the wall clock has reached since the pacing started.
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - m_StartTime).count();
+        uint64_t due = m_ClockOrigin + static_cast<uint64_t>(elapsed * m_SampleRate);
+        for (uint32_t block = 0; block < MAX_CATCH_UP_BLOCKS && GetDspClock() + m_BlockLength <= due; ++block)
+        {
+            MixBlock();
+        }
+
+        // After a hitch the pacing restarts from now instead of mixing the whole delay in the next updates.
+        if(GetDspClock() + m_BlockLength <= due)
+        {
+            m_StartTime = now;
+            m_ClockOrigin = GetDspClock();
+        }
+    }
+
+    void SoftwareBackend::SetListener(const Vector3& position, [[maybe_unused]] const Vector3* velocity, const Vector3& look, const Vector3& up)
+    {
+        //TODO: Add a multi-listener system.
+        ++m_CallCount;
+        m_ListenerPosition = position;
+
+        // Left handed like the FMOD default: the right is up x look. There is no doppler, the velocity isn't used.
+        Vector3 right = glm::cross(up, look);
+        float length = glm::length(right);
+        if(length > 1e-6f) m_ListenerRight = right / length;
+    }
+
+    uint32_t SoftwareBackend::ConsumeCallCount()
+    {
+        uint32_t count = m_CallCount;
+        m_CallCount = 0;
+        return count;
+    }
+
+    MemoryStats SoftwareBackend::GetMemoryStats()
+    {
+        return {m_MemoryUsed.load(std::memory_order_relaxed), m_MemoryPeak.load(std::memory_order_relaxed), 0};
+    }
+
+    SoftwareBackend::SoundHandle SoftwareBackend::CreateSound(const SoundDefinition& definition, LoadPriority priority, std::span<const std::byte> packEntry, bool blocking)
+    {
+        ++m_CallCount;
+        auto* sound = new SoftwareSound();
+        sound->Backend = this;
+        sound->Is3D = definition.is3D;
+        sound->IsLooping = definition.isLooping;
+        sound->MinDistance = definition.minDistance;
+        sound->MaxDistance = definition.maxDistance;
+
+        // The pack is mapped, the samples are decoded from it at once.
+        if(!packEntry.empty())
+        {
+            Decode(*sound, packEntry);
+            return sound;
+        }
+
+        if(!sound->File.Open(definition.name) || sound->File.Size() > 0xFFFFFFFFu)
+        {
+            std::cerr << "Voxaudio ERROR : Can't open the sound file " << definition.name << "." << std::endl;
+            delete sound;
+            return nullptr;
+        }
+
+        // The streams are decoded whole as well, the mixer only reads samples in memory.
+        uint32_t size = static_cast<uint32_t>(sound->File.Size());
+        sound->FileData.resize(size);
+        if(blocking)
+        {
+            int64_t bytesRead = sound->File.ReadAt(0, sound->FileData.data(), size);
+            ReadDone(sound, bytesRead);
+            return sound;
+        }
+
+        IoScheduler::Request request;
+        request.File = &sound->File;
+        request.Buffer = sound->FileData.data();
+        request.Size = size;
+        request.Priority = IoPriority::Prefetch;
+        if(definition.isStream) request.Priority = IoPriority::Stream;
+        else if(priority == LoadPriority::Imminent) request.Priority = IoPriority::Imminent;
+        request.Done = &SoftwareBackend::ReadDone;
+        request.User = sound;
+        sound->IsReading = true;
+        m_Scheduler.Submit(request);
+        return sound;
+    }
+
+    BackendLoadState SoftwareBackend::GetLoadState(SoundHandle sound)
+    {
+        return sound->State.load(std::memory_order_acquire);
+    }
+
+    uint64_t SoftwareBackend::FinishLoad(SoundHandle sound, [[maybe_unused]] const SoundDefinition& definition)
+    {
+        return sound->Audio.Samples.size() * sizeof(float);
+    }
+
+    void SoftwareBackend::ReleaseSound(SoundHandle sound)
+    {
+        ++m_CallCount;
+        // Once canceled the I/O thread doesn't touch the sound anymore.
+        if(sound->IsReading) m_Scheduler.Cancel(sound);
+        if(sound->State.load(std::memory_order_acquire) == BackendLoadState::Ready)
+        {
+            m_MemoryUsed.fetch_sub(sound->Audio.Samples.size() * sizeof(float), std::memory_order_relaxed);
+        }
+        delete sound;
+    }
+
+    SoftwareBackend::VoiceHandle SoftwareBackend::StartVoice(SoundHandle sound, uint64_t startClock)
+    {
+        ++m_CallCount;
+        SoftwareVoice* voice = m_Voices.New();
+        voice->Sound = sound;
+        voice->StartClock = startClock;
+
+        voice->ActiveIndex = static_cast<uint32_t>(m_ActiveVoices.size());
+        m_ActiveVoices.push_back(voice);
+        m_PositionsX.push_back(m_ListenerPosition.x);
+        m_PositionsY.push_back(m_ListenerPosition.y);
+        m_PositionsZ.push_back(m_ListenerPosition.z);
+        m_MinDistances.push_back(sound->MinDistance);
+        m_MaxDistances.push_back(sound->MaxDistance);
+        m_LeftGains.push_back(0.0f);
+        m_RightGains.push_back(0.0f);
+        return voice;
+    }
+
+    void SoftwareBackend::StopVoice(VoiceHandle voice)
+    {
+        ++m_CallCount;
+        uint32_t index = voice->ActiveIndex;
+        SoftwareVoice* last = m_ActiveVoices.back();
+        m_ActiveVoices[index] = last;
+        m_PositionsX[index] = m_PositionsX.back();
+        m_PositionsY[index] = m_PositionsY.back();
+        m_PositionsZ[index] = m_PositionsZ.back();
+        m_MinDistances[index] = m_MinDistances.back();
+        m_MaxDistances[index] = m_MaxDistances.back();
+        last->ActiveIndex = index;
+
+        m_ActiveVoices.pop_back();
+        m_PositionsX.pop_back();
+        m_PositionsY.pop_back();
+        m_PositionsZ.pop_back();
+        m_MinDistances.pop_back();
+        m_MaxDistances.pop_back();
+        m_LeftGains.pop_back();
+        m_RightGains.pop_back();
+        m_Voices.Delete(voice);
+    }
+
+    bool SoftwareBackend::IsVoicePlaying(VoiceHandle voice)
+    {
+        ++m_CallCount;
+        return !voice->IsFinished;
+    }
+
+    void SoftwareBackend::SetVoicePosition(VoiceHandle voice, const Vector3& position)
+    {
+        ++m_CallCount;
+        m_PositionsX[voice->ActiveIndex] = position.x;
+        m_PositionsY[voice->ActiveIndex] = position.y;
+        m_PositionsZ[voice->ActiveIndex] = position.z;
+    }
+
+    void SoftwareBackend::SetVoiceVolume(VoiceHandle voice, float gain)
+    {
+        ++m_CallCount;
+        voice->Volume = gain;
+    }
+
+    void SoftwareBackend::SetVoicePaused(VoiceHandle voice, bool paused)
+    {
+        ++m_CallCount;
+        voice->IsPaused = paused;
+    }
+
+    void SoftwareBackend::SetVoiceFadePoints(VoiceHandle voice, std::span<const FadePoint> points)
+    {
+        ++m_CallCount;
+        // The last point is always kept, the envelope ends on its gain.
+        size_t count = std::min(points.size(), SoftwareVoice::MaxFadePoints);
+        if(count > 0)
+        {
+            std::copy_n(points.begin(), count - 1, voice->FadePoints.begin());
+            voice->FadePoints[count - 1] = points.back();
+        }
+        voice->FadePointCount = static_cast<uint32_t>(count);
+        voice->NextFadePoint = 0;
+    }
+
+    void SoftwareBackend::MixBlock()
+    {
+        uint64_t clock = m_Clock.load(std::memory_order_relaxed);
+        uint64_t blockEnd = clock + m_BlockLength;
+        std::fill(m_Left.begin(), m_Left.end(), 0.0f);
+        std::fill(m_Right.begin(), m_Right.end(), 0.0f);
+
+        // The 2D voices are in the columns too, computing their gains costs less than compacting the 3D ones.
+        size_t count = m_ActiveVoices.size();
+        Simd::ComputeSpatialGains(m_PositionsX.data(), m_PositionsY.data(), m_PositionsZ.data(), m_MinDistances.data(), m_MaxDistances.data(), count,
+                                  m_ListenerPosition, m_ListenerRight, m_LeftGains.data(), m_RightGains.data());
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            SoftwareVoice& voice = *m_ActiveVoices[i];
+            if(voice.IsPaused || voice.IsFinished || voice.StartClock >= blockEnd)
+            {
+                // Nothing was mixed, the voice starts again on its gains instead of ramping from stale ones.
+                voice.HasGains = false;
+                continue;
+            }
+
+            // The gains are reached at the end of the block.
+            float gain = voice.Volume * EvaluateFadePoints(voice, blockEnd);
+            if(voice.Sound->Is3D) MixVoice(voice, clock, gain * m_LeftGains[i], gain * m_RightGains[i]);
+            else MixVoice(voice, clock, gain, gain);
+        }
+
+        Simd::InterleaveStereo(m_Left.data(), m_Right.data(), m_BlockLength, m_Interleaved.data());
+        if(m_WavWriter.IsOpen()) m_WavWriter.Write(m_Interleaved.data(), m_BlockLength);
+        m_Clock.store(blockEnd, std::memory_order_release);
+    }
+
+    void SoftwareBackend::MixVoice(SoftwareVoice& voice, uint64_t clock, float leftTarget, float rightTarget)
+    {
+        const SoftwareSound& sound = *voice.Sound;
+        const DecodedAudio& audio = sound.Audio;
+        if(audio.Frames == 0)
+        {
+            voice.IsFinished = true;
+            return;
+        }
+
+        // A scheduled start inside the block is sample accurate.
+        uint32_t offset = voice.StartClock > clock ? static_cast<uint32_t>(voice.StartClock - clock) : 0;
+        float leftStart = voice.HasGains ? voice.LeftGain : leftTarget;
+        float rightStart = voice.HasGains ? voice.RightGain : rightTarget;
+        float frames = static_cast<float>(m_BlockLength - offset);
+        float leftStep = (leftTarget - leftStart) / frames;
+        float rightStep = (rightTarget - rightStart) / frames;
+
+        const float* left = audio.Channel(0);
+        const float* right = audio.Channel(audio.Channels > 1 ? 1 : 0);
+        for (uint32_t position = offset; position < m_BlockLength;)
+        {
+            // Up to the end of the block or of the sound, a loop is mixed in several parts.
+            uint32_t length = std::min(m_BlockLength - position, audio.Frames - voice.Frame);
+            float mixed = static_cast<float>(position - offset);
+            float leftGain = leftStart + mixed * leftStep;
+            float rightGain = rightStart + mixed * rightStep;
+            if(audio.Channels == 1)
+            {
+                Simd::MixMonoToStereo(left + voice.Frame, length, leftGain, leftStep, rightGain, rightStep, m_Left.data() + position, m_Right.data() + position);
+            }
+            else
+            {
+                Simd::MixStereoToStereo(left + voice.Frame, right + voice.Frame, length, leftGain, leftStep, rightGain, rightStep, m_Left.data() + position, m_Right.data() + position);
+            }
+
+            position += length;
+            voice.Frame += length;
+            if(voice.Frame == audio.Frames)
+            {
+                if(!sound.IsLooping)
+                {
+                    voice.IsFinished = true;
+                    break;
+                }
+                voice.Frame = 0;
+            }
+        }
+
+        voice.HasGains = true;
+        voice.LeftGain = leftTarget;
+        voice.RightGain = rightTarget;
+    }
+
+    float SoftwareBackend::EvaluateFadePoints(SoftwareVoice& voice, uint64_t clock)
+    {
+        if(voice.FadePointCount == 0) return 1.0f;
+
+        uint32_t next = voice.NextFadePoint;
+        while (next < voice.FadePointCount && voice.FadePoints[next].Clock <= clock) ++next;
+        voice.NextFadePoint = next;
+        if(next == 0) return voice.FadePoints[0].Gain;
+        if(next >= voice.FadePointCount) return voice.FadePoints[voice.FadePointCount - 1].Gain;
+
+        const FadePoint& from = voice.FadePoints[next - 1];
+        const FadePoint& to = voice.FadePoints[next];
+        float t = static_cast<float>(clock - from.Clock) / static_cast<float>(to.Clock - from.Clock);
+        return from.Gain + (to.Gain - from.Gain) * t;
+    }
+
+    void SoftwareBackend::Decode(SoftwareSound& sound, std::span<const std::byte> data)
+    {
+        bool decoded = DecodeWav(data, m_SampleRate, sound.Audio);
+        if(decoded) AddMemory(sound.Audio.Samples.size() * sizeof(float));
+        sound.State.store(decoded ? BackendLoadState::Ready : BackendLoadState::Error, std::memory_order_release);
+    }
+
+    void SoftwareBackend::ReadDone(void* user, int64_t bytesRead)
+    {
+        auto* sound = static_cast<SoftwareSound*>(user);
+        if(bytesRead != static_cast<int64_t>(sound->FileData.size()))
+        {
+            std::cerr << "Voxaudio ERROR : Failed to read a sound file." << std::endl;
+            sound->State.store(BackendLoadState::Error, std::memory_order_release);
+        }
+        else
+        {
+            sound->Backend->Decode(*sound, sound->FileData);
+        }
+
+        // Only the decoded samples are kept.
+        sound->FileData = {};
+        sound->File.Close();
+    }
+
+    void SoftwareBackend::AddMemory(uint64_t bytes)
+    {
+        uint64_t used = m_MemoryUsed.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        uint64_t peak = m_MemoryPeak.load(std::memory_order_relaxed);
+        while (used > peak && !m_MemoryPeak.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {}
+    }
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include "EngineConfig.hpp"
+#include "BackendTypes.hpp"
+#include "FixedPool.hpp"
+#include "IoScheduler.hpp"
+#include "WavFile.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    class SoftwareBackend;
+
+    // A sound decoded to float at the mixer rate, shared by all its voices.
+    struct SoftwareSound
+    {
+        DecodedAudio Audio;
+        std::atomic<BackendLoadState> State = BackendLoadState::Loading;
+        bool Is3D = true;
+        bool IsLooping = false;
+        float MinDistance = 0.0f;
+        float MaxDistance = 100.0f;
+
+        // The file read by the I/O scheduler, released once decoded.
+        IoFile File;
+        std::vector<std::byte> FileData;
+        bool IsReading = false;
+        // Set by the backend, the I/O thread decodes at its rate and adds the samples to its memory.
+        SoftwareBackend* Backend = nullptr;
+    };
+
+    struct SoftwareVoice
+    {
+        static constexpr size_t MaxFadePoints = 32;
+        static constexpr uint32_t NotActive = 0xFFFFFFFF;
+
+        const SoftwareSound* Sound = nullptr;
+        // The voice waits for the clock to reach it before reading its first frame.
+        uint64_t StartClock = 0;
+        uint32_t Frame = 0;
+        float Volume = 1.0f;
+        bool IsPaused = true;
+        bool IsFinished = false;
+        // The gains mixed at the end of the previous block, the next block ramps from them.
+        bool HasGains = false;
+        float LeftGain = 0.0f;
+        float RightGain = 0.0f;
+
+        std::array<FadePoint, MaxFadePoints> FadePoints;
+        uint32_t FadePointCount = 0;
+        // First point after the last mixed block.
+        uint32_t NextFadePoint = 0;
+
+        // Index in the columns of SoftwareBackend.
+        uint32_t ActiveIndex = NotActive;
+    };
+
+    // The in-house backend, see AudioBackendType for what each function does.
+    // It mixes the voices in blocks of dspBufferLength samples on the thread calling Update, the voices are gathered in columns
+    // so the distance rolloff and the panning of a block are computed by one SIMD pass (SimdKernels::ComputeSpatialGains).
+    // The output is stereo: there is no device, the real time mode mixes at the wall clock speed into a null sink.
+    class SoftwareBackend
+    {
+    public:
+        typedef SoftwareSound* SoundHandle;
+        typedef SoftwareVoice* VoiceHandle;
+        static constexpr const char* ConfigSection = "Voxaudio.Software";
+
+        SoftwareBackend(const EngineConfig& config, const MemorySetup& memory);
+        ~SoftwareBackend();
+        SoftwareBackend(const SoftwareBackend&) = delete;
+        SoftwareBackend& operator=(const SoftwareBackend&) = delete;
+
+        int GetSampleRate() const { return static_cast<int>(m_SampleRate); }
+        float GetOutputLatencyMs() const { return m_OutputLatencyMs; }
+        // Written by the engine thread once per block.
+        uint64_t GetDspClock() const { return m_Clock.load(std::memory_order_acquire); }
+
+        void Update();
+        void SetListener(const Vector3& position, const Vector3* velocity, const Vector3& look, const Vector3& up);
+        uint32_t ConsumeCallCount();
+        MemoryStats GetMemoryStats();
+        IoStats ConsumeIoStats() { return m_Scheduler.ConsumeStats(); }
+
+        SoundHandle CreateSound(const SoundDefinition& definition, LoadPriority priority, std::span<const std::byte> packEntry, bool blocking);
+        BackendLoadState GetLoadState(SoundHandle sound);
+        uint64_t FinishLoad(SoundHandle sound, const SoundDefinition& definition);
+        void ReleaseSound(SoundHandle sound);
+
+        VoiceHandle StartVoice(SoundHandle sound, uint64_t startClock);
+        void StopVoice(VoiceHandle voice);
+        bool IsVoicePlaying(VoiceHandle voice);
+        void SetVoicePosition(VoiceHandle voice, const Vector3& position);
+        void SetVoiceVolume(VoiceHandle voice, float gain);
+        void SetVoicePaused(VoiceHandle voice, bool paused);
+        void SetVoiceFadePoints(VoiceHandle voice, std::span<const FadePoint> points);
+    private:
+        // Mix the next block in m_Left and m_Right, send it to the sink and move the clock.
+        void MixBlock();
+        void MixVoice(SoftwareVoice& voice, uint64_t clock, float leftTarget, float rightTarget);
+        // Gain of the envelope of the voice at the clock, drops the points already passed.
+        float EvaluateFadePoints(SoftwareVoice& voice, uint64_t clock);
+
+        // Decode the file data of the sound and publish its state, called by an I/O thread or by a blocking load.
+        void Decode(SoftwareSound& sound, std::span<const std::byte> data);
+        static void ReadDone(void* user, int64_t bytesRead);
+        void AddMemory(uint64_t bytes);
+    private:
+        uint32_t m_SampleRate = 48000;
+        uint32_t m_BlockLength = 480;
+        float m_OutputLatencyMs = 0.0f;
+        OutputMode m_OutputMode = OutputMode::RealTime;
+        std::atomic<uint64_t> m_Clock = 0;
+        // Real time only, the wall clock when the clock was m_ClockOrigin.
+        std::chrono::steady_clock::time_point m_StartTime;
+        uint64_t m_ClockOrigin = 0;
+
+        // The planar bus of the block and its interleaved copy for the sink.
+        std::vector<float> m_Left;
+        std::vector<float> m_Right;
+        std::vector<float> m_Interleaved;
+        WavWriter m_WavWriter;
+
+        Vector3 m_ListenerPosition = Vector3(0.0f);
+        // Unit vector toward the right ear.
+        Vector3 m_ListenerRight = Vector3(1.0f, 0.0f, 0.0f);
+
+        // Columns of the voices between StartVoice and StopVoice, indexed by SoftwareVoice::ActiveIndex and swap removed.
+        std::vector<SoftwareVoice*> m_ActiveVoices;
+        std::vector<float> m_PositionsX;
+        std::vector<float> m_PositionsY;
+        std::vector<float> m_PositionsZ;
+        std::vector<float> m_MinDistances;
+        std::vector<float> m_MaxDistances;
+        std::vector<float> m_LeftGains;
+        std::vector<float> m_RightGains;
+        FixedPool<SoftwareVoice> m_Voices;
+
+        IoScheduler m_Scheduler;
+        uint32_t m_CallCount = 0;
+        std::atomic<uint64_t> m_MemoryUsed = 0;
+        std::atomic<uint64_t> m_MemoryPeak = 0;
+    };
+}
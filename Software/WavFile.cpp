@@ -0,0 +1,201 @@
+#include "WavFile.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#define WAVE_FORMAT_PCM 0x0001
+#define WAVE_FORMAT_IEEE_FLOAT 0x0003
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+// Size of the header written by WavWriter, its data size is the last field.
+#define WAV_HEADER_SIZE 44
+
+namespace Voxymore::Audio
+{
+    // The fields of the file are little endian whatever the platform.
+    static uint16_t ReadU16(const std::byte* data)
+    {
+        return static_cast<uint16_t>(static_cast<uint16_t>(data[0]) | (static_cast<uint16_t>(data[1]) << 8));
+    }
+
+    static uint32_t ReadU32(const std::byte* data)
+    {
+        return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) | (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    static bool IsChunk(const std::byte* data, const char* id)
+    {
+        return std::memcmp(data, id, 4) == 0;
+    }
+
+    static void WriteU16(std::FILE* file, uint16_t value)
+    {
+        const unsigned char bytes[2] = {static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8)};
+        std::fwrite(bytes, 1, 2, file);
+    }
+
+    static void WriteU32(std::FILE* file, uint32_t value)
+    {
+        const unsigned char bytes[4] = {static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8), static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24)};
+        std::fwrite(bytes, 1, 4, file);
+    }
+
+    static float ReadSample(const std::byte* data, uint16_t format, uint16_t bitsPerSample)
+    {
+        if(format == WAVE_FORMAT_IEEE_FLOAT)
+        {
+            uint32_t bits = ReadU32(data);
+            float value;
+            std::memcpy(&value, &bits, sizeof(float));
+            return value;
+        }
+
+        switch (bitsPerSample)
+        {
+            // 8 bits samples are the only unsigned ones.
+            case 8: return (static_cast<float>(data[0]) - 128.0f) / 128.0f;
+            case 16: return static_cast<float>(static_cast<int16_t>(ReadU16(data))) / 32768.0f;
+            // The 3 bytes are put at the top of an int so the shift back extends the sign.
+            case 24: return static_cast<float>(static_cast<int32_t>((static_cast<uint32_t>(data[0]) << 8) | (static_cast<uint32_t>(data[1]) << 16) | (static_cast<uint32_t>(data[2]) << 24)) >> 8) / 8388608.0f;
+            default: return static_cast<float>(static_cast<int32_t>(ReadU32(data))) / 2147483648.0f;
+        }
+    }
+
+    bool DecodeWav(std::span<const std::byte> data, uint32_t sampleRate, DecodedAudio& outAudio)
+    {
+        if(data.size() < 12 || !IsChunk(data.data(), "RIFF") || !IsChunk(data.data() + 8, "WAVE"))
+        {
+            std::cerr << "Voxaudio ERROR : The sound isn't a WAVE file, only WAVE files are decoded by the software backend." << std::endl;
+            return false;
+        }
+
+        uint16_t format = 0;
+        uint16_t channels = 0;
+        uint32_t fileRate = 0;
+        uint16_t blockAlign = 0;
+        uint16_t bitsPerSample = 0;
+        std::span<const std::byte> samples;
+        for (size_t offset = 12; offset + 8 <= data.size();)
+        {
+            const std::byte* chunk = data.data() + offset;
+            size_t size = std::min<size_t>(ReadU32(chunk + 4), data.size() - offset - 8);
+            if(IsChunk(chunk, "fmt ") && size >= 16)
+            {
+                format = ReadU16(chunk + 8);
+                channels = ReadU16(chunk + 10);
+                fileRate = ReadU32(chunk + 12);
+                blockAlign = ReadU16(chunk + 20);
+                bitsPerSample = ReadU16(chunk + 22);
+                // The sub format GUID starts with the format code.
+                if(format == WAVE_FORMAT_EXTENSIBLE && size >= 40) format = ReadU16(chunk + 32);
+            }
+            else if(IsChunk(chunk, "data"))
+            {
+                samples = data.subspan(offset + 8, size);
+            }
+            // The chunks are padded to an even size.
+            offset += 8 + size + (size & 1);
+        }
+
+        bool validBits = format == WAVE_FORMAT_IEEE_FLOAT ? bitsPerSample == 32
+                : format == WAVE_FORMAT_PCM && (bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+        if(!validBits || channels == 0 || channels > 2 || fileRate == 0 || blockAlign < channels * (bitsPerSample / 8))
+        {
+            std::cerr << "Voxaudio ERROR : Unsupported WAVE format " << format << " (" << channels << " channels, " << bitsPerSample << " bits)." << std::endl;
+            return false;
+        }
+
+        uint32_t fileFrames = static_cast<uint32_t>(samples.size() / blockAlign);
+        uint32_t bytesPerSample = bitsPerSample / 8;
+        std::vector<float> planar(static_cast<size_t>(fileFrames) * channels);
+        for (uint32_t frame = 0; frame < fileFrames; ++frame)
+        {
+            const std::byte* frameData = samples.data() + static_cast<size_t>(frame) * blockAlign;
+            for (uint32_t channel = 0; channel < channels; ++channel)
+            {
+                planar[static_cast<size_t>(channel) * fileFrames + frame] = ReadSample(frameData + channel * bytesPerSample, format, bitsPerSample);
+            }
+        }
+
+        outAudio.Channels = channels;
+        if(fileRate == sampleRate || fileFrames == 0)
+        {
+            outAudio.Frames = fileFrames;
+            outAudio.Samples = std::move(planar);
+            return true;
+        }
+
+        // Linear interpolation, enough for the game assets which are authored at the mixer rate most of the time.
+        outAudio.Frames = static_cast<uint32_t>(static_cast<uint64_t>(fileFrames) * sampleRate / fileRate);
+        outAudio.Samples.resize(static_cast<size_t>(outAudio.Frames) * channels);
+        double step = static_cast<double>(fileRate) / static_cast<double>(sampleRate);
+        for (uint32_t channel = 0; channel < channels; ++channel)
+        {
+            const float* in = planar.data() + static_cast<size_t>(channel) * fileFrames;
+            float* out = outAudio.Samples.data() + static_cast<size_t>(channel) * outAudio.Frames;
+            for (uint32_t frame = 0; frame < outAudio.Frames; ++frame)
+            {
+                double position = frame * step;
+                uint32_t index = std::min(static_cast<uint32_t>(position), fileFrames - 1);
+                uint32_t next = std::min(index + 1, fileFrames - 1);
+                float t = static_cast<float>(position - index);
+                out[frame] = in[index] + (in[next] - in[index]) * t;
+            }
+        }
+        return true;
+    }
+
+    WavWriter::~WavWriter()
+    {
+        Close();
+    }
+
+    bool WavWriter::Open(const std::filesystem::path& path, uint32_t channels, uint32_t sampleRate)
+    {
+        Close();
+        m_File = std::fopen(path.string().c_str(), "wb");
+        if(!m_File)
+        {
+            std::cerr << "Voxaudio ERROR : Can't open " << path.string() << " to write the mix." << std::endl;
+            return false;
+        }
+        m_Channels = channels;
+        m_DataBytes = 0;
+
+        // The sizes are unknown until the file is closed.
+        std::fwrite("RIFF", 1, 4, m_File);
+        WriteU32(m_File, 0);
+        std::fwrite("WAVEfmt ", 1, 8, m_File);
+        WriteU32(m_File, 16);
+        WriteU16(m_File, WAVE_FORMAT_IEEE_FLOAT);
+        WriteU16(m_File, static_cast<uint16_t>(channels));
+        WriteU32(m_File, sampleRate);
+        WriteU32(m_File, sampleRate * channels * sizeof(float));
+        WriteU16(m_File, static_cast<uint16_t>(channels * sizeof(float)));
+        WriteU16(m_File, 32);
+        std::fwrite("data", 1, 4, m_File);
+        WriteU32(m_File, 0);
+        return true;
+    }
+
+    void WavWriter::Write(const float* interleaved, uint32_t frames)
+    {
+        if(!m_File) return;
+        // The mix is float already, WAVE files are little endian like the platforms the engine runs on.
+        size_t written = std::fwrite(interleaved, sizeof(float) * m_Channels, frames, m_File);
+        m_DataBytes += written * sizeof(float) * m_Channels;
+    }
+
+    void WavWriter::Close()
+    {
+        if(!m_File) return;
+
+        // A WAVE file can't describe more than 4 GB of data, the header is clamped and the readers stop there.
+        uint32_t dataBytes = static_cast<uint32_t>(std::min<uint64_t>(m_DataBytes, 0xFFFFFFFFu - WAV_HEADER_SIZE));
+        std::fseek(m_File, 4, SEEK_SET);
+        WriteU32(m_File, dataBytes + WAV_HEADER_SIZE - 8);
+        std::fseek(m_File, WAV_HEADER_SIZE - 4, SEEK_SET);
+        WriteU32(m_File, dataBytes);
+        std::fclose(m_File);
+        m_File = nullptr;
+    }
+}
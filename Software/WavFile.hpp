@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace Voxymore::Audio
+{
+    // Samples ready for the mixer: planar float, the channel c starts at Samples[c * Frames].
+    struct DecodedAudio
+    {
+        std::vector<float> Samples;
+        uint32_t Frames = 0;
+        uint32_t Channels = 0;
+
+        const float* Channel(uint32_t channel) const { return Samples.data() + static_cast<size_t>(channel) * Frames; }
+    };
+
+    // Decode a RIFF WAVE file (PCM 8, 16, 24 or 32 bits, float 32 bits, plain or extensible), mono or stereo,
+    // and resample it linearly to sampleRate. Return false with the reason on std::cerr.
+    bool DecodeWav(std::span<const std::byte> data, uint32_t sampleRate, DecodedAudio& outAudio);
+
+    // Write an interleaved float 32 bits WAVE file, the sizes of the header are patched when the file is closed.
+    class WavWriter
+    {
+    public:
+        WavWriter() = default;
+        ~WavWriter();
+
+        WavWriter(const WavWriter&) = delete;
+        WavWriter& operator=(const WavWriter&) = delete;
+
+        bool Open(const std::filesystem::path& path, uint32_t channels, uint32_t sampleRate);
+        void Close();
+        bool IsOpen() const { return m_File != nullptr; }
+
+        void Write(const float* interleaved, uint32_t frames);
+    private:
+        std::FILE* m_File = nullptr;
+        uint32_t m_Channels = 0;
+        uint64_t m_DataBytes = 0;
+    };
+}
@@ -0,0 +1,95 @@
+#include "StubBackend.hpp"
+#include <algorithm>
+
+namespace Voxymore::Audio
+{
+    StubBackend::StubBackend(const EngineConfig& config, [[maybe_unused]] const MemorySetup& memory)
+    {
+        if(config.sampleRate > 0) m_SampleRate = static_cast<uint32_t>(config.sampleRate);
+        if(config.dspBufferLength > 0) m_BlockLength = config.dspBufferLength;
+        m_Voices.SetCapacity(static_cast<uint32_t>(std::max(config.numberOfChannels, 1)));
+    }
+
+    void StubBackend::Update()
+    {
+        ++m_CallCount;
+        m_Clock.fetch_add(m_BlockLength, std::memory_order_release);
+    }
+
+    void StubBackend::SetListener([[maybe_unused]] const Vector3& position, [[maybe_unused]] const Vector3* velocity, [[maybe_unused]] const Vector3& look, [[maybe_unused]] const Vector3& up)
+    {
+        ++m_CallCount;
+    }
+
+    uint32_t StubBackend::ConsumeCallCount()
+    {
+        uint32_t count = m_CallCount;
+        m_CallCount = 0;
+        return count;
+    }
+
+    StubBackend::SoundHandle StubBackend::CreateSound(const SoundDefinition& definition, [[maybe_unused]] LoadPriority priority, [[maybe_unused]] std::span<const std::byte> packEntry, [[maybe_unused]] bool blocking)
+    {
+        ++m_CallCount;
+        auto* sound = new StubSound();
+        sound->IsLooping = definition.isLooping;
+        return sound;
+    }
+
+    BackendLoadState StubBackend::GetLoadState([[maybe_unused]] SoundHandle sound)
+    {
+        return BackendLoadState::Ready;
+    }
+
+    uint64_t StubBackend::FinishLoad([[maybe_unused]] SoundHandle sound, [[maybe_unused]] const SoundDefinition& definition)
+    {
+        return 0;
+    }
+
+    void StubBackend::ReleaseSound(SoundHandle sound)
+    {
+        ++m_CallCount;
+        delete sound;
+    }
+
+    StubBackend::VoiceHandle StubBackend::StartVoice([[maybe_unused]] SoundHandle sound, uint64_t startClock)
+    {
+        ++m_CallCount;
+        StubVoice* voice = m_Voices.New();
+        voice->StartClock = startClock;
+        return voice;
+    }
+
+    void StubBackend::StopVoice(VoiceHandle voice)
+    {
+        ++m_CallCount;
+        m_Voices.Delete(voice);
+    }
+
+    bool StubBackend::IsVoicePlaying([[maybe_unused]] VoiceHandle voice)
+    {
+        ++m_CallCount;
+        return true;
+    }
+
+    void StubBackend::SetVoicePosition([[maybe_unused]] VoiceHandle voice, [[maybe_unused]] const Vector3& position)
+    {
+        ++m_CallCount;
+    }
+
+    void StubBackend::SetVoiceVolume([[maybe_unused]] VoiceHandle voice, [[maybe_unused]] float gain)
+    {
+        ++m_CallCount;
+    }
+
+    void StubBackend::SetVoicePaused(VoiceHandle voice, bool paused)
+    {
+        ++m_CallCount;
+        voice->IsPaused = paused;
+    }
+
+    void StubBackend::SetVoiceFadePoints([[maybe_unused]] VoiceHandle voice, [[maybe_unused]] std::span<const FadePoint> points)
+    {
+        ++m_CallCount;
+    }
+}
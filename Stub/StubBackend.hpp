@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Voxaudio.hpp"
+#include "EngineConfig.hpp"
+#include "BackendTypes.hpp"
+#include "FixedPool.hpp"
+#include "IoScheduler.hpp"
+#include <atomic>
+#include <cstddef>
+#include <span>
+
+namespace Voxymore::Audio
+{
+    struct StubSound
+    {
+        bool IsLooping = false;
+    };
+
+    struct StubVoice
+    {
+        uint64_t StartClock = 0;
+        bool IsPaused = true;
+    };
+
+    // A backend that plays nothing, for the tests and the benchmarks of the engine: see AudioBackendType for what each function does.
+    // The sounds are ready as soon as they are created and the voices play until they are stopped.
+    // Each update moves the clock by one block of dspBufferLength samples, like the non real time modes of the other backends.
+    class StubBackend
+    {
+    public:
+        typedef StubSound* SoundHandle;
+        typedef StubVoice* VoiceHandle;
+        static constexpr const char* ConfigSection = "Voxaudio.Stub";
+
+        StubBackend(const EngineConfig& config, const MemorySetup& memory);
+
+        int GetSampleRate() const { return static_cast<int>(m_SampleRate); }
+        float GetOutputLatencyMs() const { return 0.0f; }
+        uint64_t GetDspClock() const { return m_Clock.load(std::memory_order_acquire); }
+
+        void Update();
+        void SetListener(const Vector3& position, const Vector3* velocity, const Vector3& look, const Vector3& up);
+        uint32_t ConsumeCallCount();
+        MemoryStats GetMemoryStats() { return {}; }
+        IoStats ConsumeIoStats() { return {}; }
+
+        SoundHandle CreateSound(const SoundDefinition& definition, LoadPriority priority, std::span<const std::byte> packEntry, bool blocking);
+        BackendLoadState GetLoadState(SoundHandle sound);
+        uint64_t FinishLoad(SoundHandle sound, const SoundDefinition& definition);
+        void ReleaseSound(SoundHandle sound);
+
+        VoiceHandle StartVoice(SoundHandle sound, uint64_t startClock);
+        void StopVoice(VoiceHandle voice);
+        bool IsVoicePlaying(VoiceHandle voice);
+        void SetVoicePosition(VoiceHandle voice, const Vector3& position);
+        void SetVoiceVolume(VoiceHandle voice, float gain);
+        void SetVoicePaused(VoiceHandle voice, bool paused);
+        void SetVoiceFadePoints(VoiceHandle voice, std::span<const FadePoint> points);
+    private:
+        uint32_t m_SampleRate = 48000;
+        uint32_t m_BlockLength = 1024;
+        std::atomic<uint64_t> m_Clock = 0;
+        uint32_t m_CallCount = 0;
+        FixedPool<StubVoice> m_Voices;
+    };
+}
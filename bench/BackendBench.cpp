@@ -0,0 +1,167 @@
+// The backends head to head: the same looping 3D voices around the listener, mixed in NoSoundNrt so each update mixes one block.
+// The backends are driven directly, without the engine. The software mixer is always compiled in, the other backends only when
+// CMake found their dependency.
+
+#include "Voxaudio.hpp"
+#include "EngineConfig.hpp"
+#include "BackendTypes.hpp"
+#include "SoftwareBackend.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <vector>
+
+#ifdef VXM_BENCH_MINIAUDIO
+    #include "MiniaudioBackend.hpp"
+#endif
+#ifdef VXM_BENCH_FMOD_CORE
+    #include "FmodBackend.hpp"
+#endif
+
+using namespace Voxymore::Audio;
+
+#define SAMPLE_RATE 48000
+// 10 ms blocks.
+#define BLOCK_LENGTH 480
+#define WARMUP_BLOCKS 50
+#define MEASURED_BLOCKS 500
+// The voices are spread between 5 m and the max distance so they are all audible.
+#define MAX_DISTANCE 100.0f
+
+struct BlockTimes
+{
+    double Mean = 0.0;
+    double P99 = 0.0;
+};
+
+// One second of a 440 Hz sine, mono 16 bits, given to the backends as the entry of a pack.
+static std::vector<std::byte> MakeSineWav()
+{
+    const uint32_t frames = SAMPLE_RATE;
+    std::vector<std::byte> wav(44 + frames * 2);
+    auto write = [&wav](size_t offset, uint32_t value, uint32_t size)
+    {
+        for (uint32_t i = 0; i < size; ++i) wav[offset + i] = static_cast<std::byte>((value >> (8 * i)) & 0xFF);
+    };
+    std::memcpy(wav.data(), "RIFF", 4);
+    write(4, static_cast<uint32_t>(wav.size() - 8), 4);
+    std::memcpy(wav.data() + 8, "WAVEfmt ", 8);
+    write(16, 16, 4);
+    write(20, 1, 2);
+    write(22, 1, 2);
+    write(24, SAMPLE_RATE, 4);
+    write(28, SAMPLE_RATE * 2, 4);
+    write(32, 2, 2);
+    write(34, 16, 2);
+    std::memcpy(wav.data() + 36, "data", 4);
+    write(40, frames * 2, 4);
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        auto sample = static_cast<int16_t>(std::sin(2.0 * 3.14159265358979 * 440.0 * frame / SAMPLE_RATE) * 16000.0);
+        write(44 + frame * 2, static_cast<uint16_t>(sample), 2);
+    }
+    return wav;
+}
+
+static Vector3 VoicePosition(uint32_t voice, uint32_t block)
+{
+    float angle = static_cast<float>(voice) * 2.39996f + static_cast<float>(block) * 0.01f;
+    float distance = 5.0f + static_cast<float>(voice % 90);
+    return Vector3(std::cos(angle) * distance, 0.0f, std::sin(angle) * distance);
+}
+
+template<typename Backend>
+static BlockTimes RunBackendBench(uint32_t voiceCount, std::span<const std::byte> wav)
+{
+    EngineConfig config;
+    config.numberOfChannels = static_cast<int>(voiceCount);
+    // FMOD virtualizes the voices beyond its software channels, they must all be mixed to compare.
+    config.softwareChannels = static_cast<int>(voiceCount);
+    config.sampleRate = SAMPLE_RATE;
+    config.dspBufferLength = BLOCK_LENGTH;
+    config.outputMode = OutputMode::NoSoundNrt;
+    config.useAsyncFileSystem = false;
+    Backend backend(config, MemorySetup{});
+
+    SoundDefinition definition{"BackendBench.wav"};
+    definition.minDistance = 1.0f;
+    definition.maxDistance = MAX_DISTANCE;
+    definition.isLooping = true;
+    typename Backend::SoundHandle sound = backend.CreateSound(definition, LoadPriority::Imminent, wav, true);
+    if(!sound || backend.GetLoadState(sound) != BackendLoadState::Ready)
+    {
+        std::cerr << "Voxaudio ERROR : The backend couldn't load the benchmark sound." << std::endl;
+        return {};
+    }
+    backend.FinishLoad(sound, definition);
+
+    Vector3 look(0.0f, 0.0f, 1.0f);
+    Vector3 up(0.0f, 1.0f, 0.0f);
+    backend.SetListener(Vector3(0.0f), nullptr, look, up);
+    std::vector<typename Backend::VoiceHandle> voices(voiceCount);
+    for (uint32_t i = 0; i < voiceCount; ++i)
+    {
+        voices[i] = backend.StartVoice(sound, 0);
+        backend.SetVoicePosition(voices[i], VoicePosition(i, 0));
+        backend.SetVoiceVolume(voices[i], 0.5f);
+        backend.SetVoicePaused(voices[i], false);
+    }
+
+    // 10% of the voices move every block, the time includes their calls.
+    uint32_t movedPerBlock = std::max<uint32_t>(voiceCount / 10, 1);
+    std::vector<double> times;
+    times.reserve(MEASURED_BLOCKS);
+    for (uint32_t block = 0; block < WARMUP_BLOCKS + MEASURED_BLOCKS; ++block)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < movedPerBlock; ++i)
+        {
+            uint32_t voice = (block * movedPerBlock + i) % voiceCount;
+            backend.SetVoicePosition(voices[voice], VoicePosition(voice, block));
+        }
+        backend.Update();
+        auto end = std::chrono::steady_clock::now();
+        if(block >= WARMUP_BLOCKS) times.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    for (auto voice : voices) backend.StopVoice(voice);
+    backend.ReleaseSound(sound);
+
+    BlockTimes result;
+    for (double time : times) result.Mean += time;
+    result.Mean /= static_cast<double>(times.size());
+    std::sort(times.begin(), times.end());
+    result.P99 = times[times.size() * 99 / 100];
+    return result;
+}
+
+template<typename Backend>
+static void PrintBackendBench(const char* name, std::span<const std::byte> wav)
+{
+    for (uint32_t voiceCount : {100u, 1000u})
+    {
+        BlockTimes times = RunBackendBench<Backend>(voiceCount, wav);
+        // The share of a core used to mix in real time.
+        double load = 100.0 * times.Mean / (1.0e6 * BLOCK_LENGTH / SAMPLE_RATE);
+        std::printf("%-10s %8u %12.1f %12.1f %9.1f%%\n", name, voiceCount, times.Mean, times.P99, load);
+    }
+}
+
+int main()
+{
+    std::vector<std::byte> wav = MakeSineWav();
+    std::printf("One %d samples block (%.0f ms) per update at %d Hz, %d blocks\n", BLOCK_LENGTH, 1000.0 * BLOCK_LENGTH / SAMPLE_RATE, SAMPLE_RATE, MEASURED_BLOCKS);
+    std::printf("%-10s %8s %12s %12s %10s\n", "backend", "voices", "mean (us)", "p99 (us)", "cpu");
+    PrintBackendBench<SoftwareBackend>("Software", wav);
+#ifdef VXM_BENCH_FMOD_CORE
+    PrintBackendBench<FmodBackend>("FMOD", wav);
+#endif
+#ifdef VXM_BENCH_MINIAUDIO
+    PrintBackendBench<MiniaudioBackend>("miniaudio", wav);
+#endif
+    return 0;
+}
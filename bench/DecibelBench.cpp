@@ -0,0 +1,93 @@
+// Throughput and error of the SIMD decibel conversions (the span versions of Helper::dBToVolume and Helper::VolumeTodB)
+// against a loop calling libm powf and log10f, over the range the engine uses: [-120, 120] dB.
+
+#include "Voxaudio.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace Voxymore::Audio;
+
+// About the number of active channels converted by an update, small enough to stay in the L1 cache.
+#define BATCH_SIZE 4096
+#define REPETITIONS 20000
+#define MIN_DECIBELS -120.0f
+#define MAX_DECIBELS 120.0f
+
+// Keeps the results alive so the loops aren't optimized away.
+static volatile float s_Sink = 0.0f;
+
+template<typename Func>
+static double MeasureNsPerValue(Func&& func)
+{
+    // One pass to warm the caches.
+    func();
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < REPETITIONS; ++i) func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(REPETITIONS) * BATCH_SIZE);
+}
+
+int main()
+{
+    std::vector<float> decibels(BATCH_SIZE);
+    std::vector<float> volumes(BATCH_SIZE);
+    for (uint32_t i = 0; i < BATCH_SIZE; ++i)
+    {
+        decibels[i] = MIN_DECIBELS + (MAX_DECIBELS - MIN_DECIBELS) * static_cast<float>(i) / static_cast<float>(BATCH_SIZE - 1);
+        volumes[i] = static_cast<float>(std::pow(10.0, decibels[i] / 20.0));
+    }
+    std::vector<float> libmOut(BATCH_SIZE);
+    std::vector<float> simdOut(BATCH_SIZE);
+
+    double libmToVolume = MeasureNsPerValue([&]()
+    {
+        for (uint32_t i = 0; i < BATCH_SIZE; ++i) libmOut[i] = powf(10.0f, 0.05f * decibels[i]);
+        s_Sink = libmOut[BATCH_SIZE / 2];
+    });
+    double simdToVolume = MeasureNsPerValue([&]()
+    {
+        Helper::dBToVolume(decibels, simdOut);
+        s_Sink = simdOut[BATCH_SIZE / 2];
+    });
+    // Relative error, against the double precision result.
+    double libmToVolumeError = 0.0;
+    double simdToVolumeError = 0.0;
+    for (uint32_t i = 0; i < BATCH_SIZE; ++i)
+    {
+        double exact = std::pow(10.0, decibels[i] / 20.0);
+        libmToVolumeError = std::max(libmToVolumeError, std::abs(libmOut[i] - exact) / exact);
+        simdToVolumeError = std::max(simdToVolumeError, std::abs(simdOut[i] - exact) / exact);
+    }
+
+    double libmTodB = MeasureNsPerValue([&]()
+    {
+        for (uint32_t i = 0; i < BATCH_SIZE; ++i) libmOut[i] = 20.0f * log10f(volumes[i]);
+        s_Sink = libmOut[BATCH_SIZE / 2];
+    });
+    double simdTodB = MeasureNsPerValue([&]()
+    {
+        Helper::VolumeTodB(volumes, simdOut);
+        s_Sink = simdOut[BATCH_SIZE / 2];
+    });
+    // Absolute error in dB, against the double precision result.
+    double libmTodBError = 0.0;
+    double simdTodBError = 0.0;
+    for (uint32_t i = 0; i < BATCH_SIZE; ++i)
+    {
+        double exact = 20.0 * std::log10(static_cast<double>(volumes[i]));
+        libmTodBError = std::max(libmTodBError, std::abs(libmOut[i] - exact));
+        simdTodBError = std::max(simdTodBError, std::abs(simdOut[i] - exact));
+    }
+
+    std::printf("Decibel conversions, %d values in [%g, %g] dB, %d repetitions\n", BATCH_SIZE, MIN_DECIBELS, MAX_DECIBELS, REPETITIONS);
+    std::printf("%-22s %12s %12s %10s\n", "", "ns / value", "max error", "speedup");
+    std::printf("%-22s %12.3f %12.3g %10s\n", "powf", libmToVolume, libmToVolumeError, "");
+    std::printf("%-22s %12.3f %12.3g %9.1fx\n", "Helper::dBToVolume", simdToVolume, simdToVolumeError, libmToVolume / simdToVolume);
+    std::printf("%-22s %12.3f %12.3g %10s\n", "log10f", libmTodB, libmTodBError, "");
+    std::printf("%-22s %12.3f %12.3g %9.1fx\n", "Helper::VolumeTodB", simdTodB, simdTodBError, libmTodB / simdTodB);
+    std::printf("The dBToVolume errors are relative, the VolumeTodB errors are in dB.\n");
+    return 0;
+}
@@ -0,0 +1,102 @@
+// Cost of Voxaudio::Update for 1k, 10k and 100k looping 3D channels over the stub backend.
+// The channels are spread on a square around the listener so most are dormant, some virtual and realVoiceBudget real,
+// 1% of them move every frame and the listener walks a circle.
+
+#include "Voxaudio.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace Voxymore::Audio;
+
+#define WARMUP_FRAMES 120
+#define MEASURED_FRAMES 1000
+// Side of the square holding the channels, the sound is heard up to 100 m.
+#define WORLD_SIZE 4000.0f
+
+struct FrameTimes
+{
+    double Mean = 0.0;
+    double Median = 0.0;
+    double P99 = 0.0;
+};
+
+static FrameTimes RunUpdateBench(uint32_t channelCount, const std::filesystem::path& configPath)
+{
+    {
+        std::ofstream config(configPath);
+        config << "Voxaudio.Stub:\n"
+               << "  NumberOfChannels: 128\n"
+               << "  MaxChannels: " << std::max<uint32_t>(channelCount * 2, 65536) << "\n"
+               << "  CommandQueueCapacity: " << std::max<uint32_t>(channelCount, 8192) << "\n";
+    }
+    Voxaudio::Init(configPath);
+
+    SoundDefinition definition{"bench_loop.wav"};
+    definition.minDistance = 1.0f;
+    definition.maxDistance = 100.0f;
+    definition.isLooping = true;
+    TypeId sound = Voxaudio::RegisterSound(definition);
+
+    // A square grid of channels, deterministic so the runs can be compared.
+    uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(channelCount))));
+    float spacing = WORLD_SIZE / static_cast<float>(side);
+    std::vector<TypeId> sounds(channelCount, sound);
+    std::vector<Vector3> positions(channelCount);
+    std::vector<TypeId> channels(channelCount);
+    for (uint32_t i = 0; i < channelCount; ++i)
+    {
+        positions[i] = Vector3(static_cast<float>(i % side) * spacing - WORLD_SIZE * 0.5f, 0.0f, static_cast<float>(i / side) * spacing - WORLD_SIZE * 0.5f);
+    }
+    Voxaudio::PlaySounds(sounds, positions, {}, channels);
+
+    uint32_t movedPerFrame = std::max<uint32_t>(channelCount / 100, 1);
+    std::vector<TypeId> movedChannels(movedPerFrame);
+    std::vector<Vector3> movedPositions(movedPerFrame);
+    std::vector<double> times;
+    times.reserve(MEASURED_FRAMES);
+    for (uint32_t frame = 0; frame < WARMUP_FRAMES + MEASURED_FRAMES; ++frame)
+    {
+        float angle = static_cast<float>(frame) * 0.01f;
+        Voxaudio::Set3dListenerAndOrientation(Vector3(std::cos(angle) * 200.0f, 0.0f, std::sin(angle) * 200.0f), Vector3(0.0f, 0.0f, 1.0f), Vector3(0.0f, 1.0f, 0.0f));
+        for (uint32_t i = 0; i < movedPerFrame; ++i)
+        {
+            uint32_t channel = (frame * movedPerFrame + i) % channelCount;
+            movedChannels[i] = channels[channel];
+            movedPositions[i] = positions[channel] + Vector3(std::sin(angle) * spacing * 0.5f, 0.0f, 0.0f);
+        }
+        Voxaudio::SetChannel3dPositions(movedChannels, movedPositions);
+
+        auto start = std::chrono::steady_clock::now();
+        Voxaudio::Update(1.0f / 60.0f);
+        auto end = std::chrono::steady_clock::now();
+        if(frame >= WARMUP_FRAMES) times.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    Voxaudio::Shutdown();
+
+    FrameTimes result;
+    for (double time : times) result.Mean += time;
+    result.Mean /= static_cast<double>(times.size());
+    std::sort(times.begin(), times.end());
+    result.Median = times[times.size() / 2];
+    result.P99 = times[times.size() * 99 / 100];
+    return result;
+}
+
+int main()
+{
+    std::filesystem::path configPath = std::filesystem::temp_directory_path() / "VoxaudioUpdateBench.vxm";
+    std::printf("Voxaudio::Update per frame, stub backend, %d frames\n", MEASURED_FRAMES);
+    std::printf("%10s %12s %12s %12s\n", "channels", "mean (us)", "median (us)", "p99 (us)");
+    for (uint32_t channelCount : {1000u, 10000u, 100000u})
+    {
+        FrameTimes times = RunUpdateBench(channelCount, configPath);
+        std::printf("%10u %12.1f %12.1f %12.1f\n", channelCount, times.Mean, times.Median, times.P99);
+    }
+    std::filesystem::remove(configPath);
+    return 0;
+}
@@ -4,25 +4,57 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <filesystem>
+#include <span>
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace Voxymore::Audio
 {
 	using Vector3 = glm::vec3;
     typedef uint32_t TypeId;
+    // Never a valid sound or channel id.
+    inline constexpr TypeId NullId = 0;
 
-    //TODO: Find a way to save and load all the sound definitions from disk
+    // Can be saved and loaded from disk, see Voxaudio::RegisterSoundManifest and Voxaudio::RegisterSoundRegistry.
     struct SoundDefinition
     {
         std::string name;
         float defaultVolumedB = 30.0f;
         float minDistance = 0.0f;
         float maxDistance = 100.0f;
+        // Added to the audibility (in dB) when the channels compete for a real voice. Higher is more important.
+        float priority = 0.0f;
         bool is3D = true;
         bool isLooping = false;
         bool isStream = false;
+        // A pinned sound is never evicted to respect the sample memory budget once loaded.
+        bool pinned = false;
+    };
+
+    // The loads are issued in this order, a few per update.
+    enum class LoadPriority : uint8_t
+    {
+        // A channel is waiting for the sound to start.
+        Imminent,
+        // Explicit LoadSound, the sound is expected to be played soon.
+        Prefetch,
+        Background,
+        Count,
+    };
+
+    // How the volume moves from the start to the end of a fade.
+    enum class FadeShape : uint8_t
+    {
+        // Constant speed in dB, what the ear perceives as a constant speed.
+        LinearDecibel,
+        // The gains follow a quarter of sine, the power stays constant when crossfading two sounds.
+        EqualPower,
+        // Smoothstep on the gain, slow at both ends.
+        SCurve,
     };
 
     struct OneShotSound
@@ -31,17 +63,111 @@ namespace Voxymore::Audio
         TypeId ChannelId;
     };
 
+    // Where the backend takes its memory, given to Voxaudio::Init. By default it uses its own heap.
+    struct MemorySetup
+    {
+        // A block the backend allocates from, it never grows. FMOD needs a size multiple of 512 bytes.
+        // The block must stay valid until Voxaudio::Shutdown.
+        // FMOD takes its memory once per process: when Voxaudio is initialized again the setup must be the same and its block must
+        // still be valid, a different setup is rejected with an error and the first one is kept.
+        void* block = nullptr;
+        uint32_t blockSize = 0;
+        // Or an allocator, ignored when a block is given. The functions are called from the backend threads.
+        void* (*alloc)(size_t size, void* user) = nullptr;
+        void* (*realloc)(void* ptr, size_t size, void* user) = nullptr;
+        void (*free)(void* ptr, void* user) = nullptr;
+        void* user = nullptr;
+    };
+
+    enum class MemoryCategory : uint8_t
+    {
+        // Bytes allocated by the backend.
+        Backend,
+        // Slots of the fixed pools.
+        Sounds,
+        Channels,
+        // Sound definitions travelling from the caller thread to the engine.
+        SoundDefinitions,
+        // Channel arrays of the bulk functions travelling to the engine.
+        ChannelBatches,
+        Count,
+    };
+
+    struct MemoryStats
+    {
+        uint64_t used = 0;
+        // Highest value of used since Init.
+        uint64_t peak = 0;
+        // 0 when the category can grow.
+        uint64_t capacity = 0;
+    };
+
+    // Counters of the last Voxaudio::Update.
+    struct EngineStats
+    {
+        // Calls made to the backend API (e.g. FMOD) since the previous update, including the ones made by the update itself.
+        uint32_t backendCalls = 0;
+        uint32_t positionUpdates = 0;
+        uint32_t volumeUpdates = 0;
+        uint32_t activeChannels = 0;
+        uint32_t dormantChannels = 0;
+        uint32_t loadsIssued = 0;
+        uint32_t loadsCompleted = 0;
+        uint32_t loadsPending = 0;
+        // Longest time between the load request and the sound being playable, among the loads completed by the update.
+        float maxLoadLatencyMs = 0.0f;
+        // Estimated memory of the loaded sound data, and the sounds unloaded by the update to respect the budget.
+        uint64_t residentSampleBytes = 0;
+        uint32_t soundsEvicted = 0;
+        // File reads served by the I/O scheduler since the previous update, and the time from their request to their completion.
+        uint32_t ioReads = 0;
+        uint64_t ioBytesRead = 0;
+        float ioAverageLatencyMs = 0.0f;
+        float ioMaxLatencyMs = 0.0f;
+        std::array<MemoryStats, static_cast<size_t>(MemoryCategory::Count)> memory{};
+        // Sound definitions allocated on the heap because their pool was full.
+        uint32_t soundDefinitionPoolOverflows = 0;
+        // Same for the channel batches of the bulk functions.
+        uint32_t channelBatchPoolOverflows = 0;
+        // Channels handed to the mixer by the update, and the time from their PlaySound call to that moment
+        // (the command queue, the update period and the loads). PlaySoundAt channels aren't counted.
+        uint32_t channelsStarted = 0;
+        float startLatencyAverageMs = 0.0f;
+        float startLatencyMaxMs = 0.0f;
+        // Audio buffered between the mixer and the device, dspBufferLength * dspBufferCount samples as used by the backend (0 without real time).
+        // The trigger to output latency is the start latency plus this one.
+        float outputLatencyMs = 0.0f;
+    };
+
 	class Voxaudio
 	{
 	public:
-		static void Init(const std::filesystem::path& configFile = "");
+		static void Init(const std::filesystem::path& configFile = "", const MemorySetup& memory = {});
+        // Execute the commands and update the channels and the backend, nothing to do when the engine has its own thread (UseEngineThread).
+        // deltaTimeSeconds is ignored: the fades follow the mixer clock of the backend, not the frame time.
 		static void Update(float deltaTimeSeconds);
 		static void Shutdown();
 
         static TypeId RegisterSound(const SoundDefinition& soundDef, bool load = true);
         static void UnregisterSound(TypeId soundId);
 
-        static void LoadSound(TypeId soundId);
+        // Register every definition at once, outSoundIds[i] receives the id of soundDefs[i] (NullId when the sound table is full).
+        // The loads are requested with the Background priority.
+        static void RegisterSounds(std::span<const SoundDefinition> soundDefs, std::span<TypeId> outSoundIds, bool load = false);
+        // Register the sounds of a YAML manifest, the ids are in the order of the manifest. Empty if the manifest can't be read.
+        static std::vector<TypeId> RegisterSoundManifest(const std::filesystem::path& manifestPath, bool load = false);
+        static bool SaveSoundManifest(const std::filesystem::path& manifestPath, std::span<const SoundDefinition> soundDefs);
+        // Compile a YAML manifest in a binary registry that is registered without any parsing.
+        static bool CompileSoundManifest(const std::filesystem::path& manifestPath, const std::filesystem::path& registryPath);
+        static std::vector<TypeId> RegisterSoundRegistry(const std::filesystem::path& registryPath, bool load = false);
+
+        // Pack the files in a single memory-mapped archive, each entry is named by its path relative to root ('/' separators).
+        static bool BuildSoundPack(std::span<const std::filesystem::path> files, const std::filesystem::path& root, const std::filesystem::path& packPath);
+        // Once mounted, a sound whose name is an entry of the pack is loaded from the pack instead of the file system.
+        // The packs mounted last are looked up first. Return false if the pack can't be opened.
+        static bool MountSoundPack(const std::filesystem::path& packPath);
+
+        static void LoadSound(TypeId soundId, LoadPriority priority = LoadPriority::Prefetch);
         static void UnloadSound(TypeId soundId);
 
         //TODO: bool ShouldBeVirtual(bool allowOneShotVirtuals) const
@@ -50,19 +176,48 @@ namespace Voxymore::Audio
 		static void Set3dListenerAndOrientation(const Vector3& position, const Vector3& look, const Vector3& up, const Vector3& velocity);
 
 		static TypeId PlaySound(TypeId soundId, const Vector3& pos = { 0,0,0 }, float volumedB = 0.0f);
+        // Start the sound on the sample dspClock of the mixer (see GetDspClock), regardless of when the update executes the call.
+        // The clock must be ahead of GetDspClock by at least the update period plus the mixer latency, a time already passed starts as soon as possible.
+        // The sound should be loaded beforehand, a load still running at that time delays the start.
+        static TypeId PlaySoundAt(TypeId soundId, uint64_t dspClock, const Vector3& pos = { 0,0,0 }, float volumedB = 0.0f);
+        // The sound is shared by every one shot with the same name, 3D, looping, streaming and distance settings.
+        // The other settings (priority, default volume, pinned) are the ones of the first definition that created the sound.
+        // It is owned by the engine, unregistering or unloading it does nothing.
         static OneShotSound PlayOnShot(const SoundDefinition& soundDef, const Vector3& pos = { 0,0,0 }, float volumedB = 0.0f);
 
-		static void StopChannel(TypeId channelId, float fadeTimeSeconds = 0.0f);
+		static void StopChannel(TypeId channelId, float fadeTimeSeconds = 0.0f, FadeShape fadeShape = FadeShape::LinearDecibel);
 		static void StopAllChannels();
 
 		static void SetChannel3dPosition(TypeId channelId, const Vector3& position);
 		static void SetChannelVolume(TypeId channelId, float volumedB);
 		static bool IsPlaying(TypeId channelId);
+
+        // Bulk versions of the functions above, the channels are copied by batches of 64 that the engine executes in one loop.
+        // When the spans don't have the same size only the common prefix is used.
+        // volumesdB may be empty (0 dB), outChannelIds receives the id of each new channel.
+        static void PlaySounds(std::span<const TypeId> soundIds, std::span<const Vector3> positions, std::span<const float> volumesdB, std::span<TypeId> outChannelIds);
+        static void StopChannels(std::span<const TypeId> channelIds, float fadeTimeSeconds = 0.0f, FadeShape fadeShape = FadeShape::LinearDecibel);
+        static void SetChannel3dPositions(std::span<const TypeId> channelIds, std::span<const Vector3> positions);
+        static void SetChannelVolumes(std::span<const TypeId> channelIds, std::span<const float> volumesdB);
+
+        static EngineStats GetStats();
+
+        // Current position of the mixer, in samples since the initialization. Safe to call from any thread.
+        static uint64_t GetDspClock();
+        // Samples per second of the mixer, to convert a time to a DSP clock.
+        static int GetSampleRate();
 	};
 
     namespace Helper
     {
         float dBToVolume(float dB);
         float VolumeTodB(float Volume);
+
+        // Vectorized versions for arrays, only the common prefix is used when the spans don't have the same size.
+        // The output may be the input (in place).
+        // Relative error below 1e-6 in [-120, 120] dB.
+        void dBToVolume(std::span<const float> decibels, std::span<float> outVolumes);
+        // Error below 2e-7 * max(6, |dB|) dB. A volume of 0 gives about -758 dB instead of -inf.
+        void VolumeTodB(std::span<const float> volumes, std::span<float> outDecibels);
     }
 }
\ No newline at end of file
@@ -0,0 +1,148 @@
+// Voxaudio::Update must not allocate once the engine is warmed up: every operator new of the process is counted while a script
+// of PlaySound, SetChannel3dPosition and StopChannel runs for 10k frames over the stub backend, and any allocation fails the test.
+
+#include "Voxaudio.hpp"
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+
+using namespace Voxymore::Audio;
+
+#define WARMUP_FRAMES 600
+#define TESTED_FRAMES 10000
+// Channels alive at once, the oldest ones are stopped as the new ones start.
+#define LIVE_CHANNELS 256
+#define STARTED_PER_FRAME 4
+#define MOVED_PER_FRAME 32
+
+static std::atomic<bool> s_Counting = false;
+static std::atomic<uint64_t> s_Allocations = 0;
+
+static void* CountedAlloc(std::size_t size, std::size_t alignment)
+{
+    if(s_Counting.load(std::memory_order_relaxed)) s_Allocations.fetch_add(1, std::memory_order_relaxed);
+    if(size == 0) size = 1;
+    if(alignment <= alignof(std::max_align_t)) return std::malloc(size);
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    // aligned_alloc wants a size multiple of the alignment.
+    return std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+}
+
+static void CountedFree(void* ptr, std::size_t alignment)
+{
+#ifdef _WIN32
+    if(alignment > alignof(std::max_align_t))
+    {
+        _aligned_free(ptr);
+        return;
+    }
+#else
+    (void)alignment;
+#endif
+    std::free(ptr);
+}
+
+static void* CountedNew(std::size_t size, std::size_t alignment)
+{
+    void* ptr = CountedAlloc(size, alignment);
+    if(!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(std::size_t size) { return CountedNew(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return CountedNew(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return CountedNew(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return CountedNew(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAlloc(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAlloc(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* ptr) noexcept { CountedFree(ptr, alignof(std::max_align_t)); }
+void operator delete[](void* ptr) noexcept { CountedFree(ptr, alignof(std::max_align_t)); }
+void operator delete(void* ptr, std::size_t) noexcept { CountedFree(ptr, alignof(std::max_align_t)); }
+void operator delete[](void* ptr, std::size_t) noexcept { CountedFree(ptr, alignof(std::max_align_t)); }
+void operator delete(void* ptr, std::align_val_t alignment) noexcept { CountedFree(ptr, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept { CountedFree(ptr, static_cast<std::size_t>(alignment)); }
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept { CountedFree(ptr, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept { CountedFree(ptr, static_cast<std::size_t>(alignment)); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { CountedFree(ptr, alignof(std::max_align_t)); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { CountedFree(ptr, alignof(std::max_align_t)); }
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept { CountedFree(ptr, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept { CountedFree(ptr, static_cast<std::size_t>(alignment)); }
+
+// The same frame is played during the warm-up and the test: some channels start, some move and the oldest stop, half of them with a fade.
+// The channels are around the listener so they go through the real, virtual and dormant states as it walks.
+static void RunFrame(uint32_t frame, TypeId sound, std::array<TypeId, LIVE_CHANNELS>& channels)
+{
+    float angle = static_cast<float>(frame) * 0.02f;
+    Voxaudio::Set3dListenerAndOrientation(Vector3(std::cos(angle) * 150.0f, 0.0f, std::sin(angle) * 150.0f), Vector3(0.0f, 0.0f, 1.0f), Vector3(0.0f, 1.0f, 0.0f));
+
+    for (uint32_t i = 0; i < STARTED_PER_FRAME; ++i)
+    {
+        uint32_t index = (frame * STARTED_PER_FRAME + i) % LIVE_CHANNELS;
+        if(channels[index] != NullId) Voxaudio::StopChannel(channels[index], (index & 1) ? 0.1f : 0.0f);
+        float place = static_cast<float>(frame * STARTED_PER_FRAME + i) * 0.37f;
+        channels[index] = Voxaudio::PlaySound(sound, Vector3(std::cos(place) * 300.0f, 0.0f, std::sin(place) * 300.0f));
+    }
+
+    for (uint32_t i = 0; i < MOVED_PER_FRAME; ++i)
+    {
+        uint32_t index = (frame * MOVED_PER_FRAME + i) % LIVE_CHANNELS;
+        float place = static_cast<float>(frame + index);
+        Voxaudio::SetChannel3dPosition(channels[index], Vector3(std::cos(place) * 250.0f, 0.0f, std::sin(place * 0.5f) * 250.0f));
+    }
+
+    Voxaudio::Update(1.0f / 60.0f);
+}
+
+int main()
+{
+    std::filesystem::path configPath = std::filesystem::temp_directory_path() / "VoxaudioAllocationTest.vxm";
+    {
+        std::ofstream config(configPath);
+        config << "Voxaudio.Stub:\n"
+               << "  NumberOfChannels: 64\n"
+               << "  MaxChannels: 4096\n";
+    }
+    Voxaudio::Init(configPath);
+
+    SoundDefinition definition{"test_loop.wav"};
+    definition.minDistance = 1.0f;
+    definition.maxDistance = 100.0f;
+    definition.isLooping = true;
+    TypeId sound = Voxaudio::RegisterSound(definition);
+
+    std::array<TypeId, LIVE_CHANNELS> channels;
+    channels.fill(NullId);
+    for (uint32_t frame = 0; frame < WARMUP_FRAMES; ++frame) RunFrame(frame, sound, channels);
+
+    s_Counting = true;
+    uint32_t firstAllocatingFrame = 0;
+    for (uint32_t frame = WARMUP_FRAMES; frame < WARMUP_FRAMES + TESTED_FRAMES; ++frame)
+    {
+        RunFrame(frame, sound, channels);
+        if(firstAllocatingFrame == 0 && s_Allocations.load() > 0) firstAllocatingFrame = frame;
+    }
+    s_Counting = false;
+
+    uint64_t allocations = s_Allocations.load();
+    Voxaudio::Shutdown();
+    std::filesystem::remove(configPath);
+
+    if(allocations > 0)
+    {
+        std::printf("FAILED: %llu allocations in %d frames after the warm-up, the first one in frame %u.\n", static_cast<unsigned long long>(allocations), TESTED_FRAMES, firstAllocatingFrame);
+        return 1;
+    }
+    std::printf("OK: no allocation in %d frames after the warm-up.\n", TESTED_FRAMES);
+    return 0;
+}
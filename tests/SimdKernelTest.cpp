@@ -0,0 +1,102 @@
+// The SIMD kernels against a double precision reference, within the bounds of their documentation.
+// Run on each instruction set the kernels are compiled with (SSE2, AVX2 and NEON through the CI jobs).
+
+#include "SimdKernels.hpp"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace Voxymore::Audio;
+
+// Not a multiple of any vector width, so the scalar tails are tested too.
+#define VALUE_COUNT 1003
+#define PI 3.14159265358979323846
+
+static bool Check(const char* name, double error, double bound)
+{
+    bool passed = error <= bound;
+    std::printf("%-24s max error %-10.3g bound %-10.3g %s\n", name, error, bound, passed ? "OK" : "FAILED");
+    return passed;
+}
+
+int main()
+{
+    std::printf("Instruction set: %s\n", Simd::GetInstructionSet());
+    bool passed = true;
+
+    std::vector<float> decibels(VALUE_COUNT);
+    std::vector<float> gains(VALUE_COUNT);
+    std::vector<float> roundTrip(VALUE_COUNT);
+    for (size_t i = 0; i < VALUE_COUNT; ++i) decibels[i] = -120.0f + 240.0f * static_cast<float>(i) / (VALUE_COUNT - 1);
+    Simd::DecibelsToGains(decibels.data(), VALUE_COUNT, gains.data());
+    Simd::GainsToDecibels(gains.data(), VALUE_COUNT, roundTrip.data());
+    double gainError = 0.0;
+    double decibelError = 0.0;
+    for (size_t i = 0; i < VALUE_COUNT; ++i)
+    {
+        double gain = std::pow(10.0, decibels[i] / 20.0);
+        gainError = std::fmax(gainError, std::fabs(gains[i] - gain) / gain);
+        // Relative to max(6, |dB|) like the bound of the documentation.
+        double decibel = 20.0 * std::log10(static_cast<double>(gains[i]));
+        decibelError = std::fmax(decibelError, std::fabs(roundTrip[i] - decibel) / std::fmax(6.0, std::fabs(decibel)));
+    }
+    passed &= Check("DecibelsToGains", gainError, 1e-6);
+    passed &= Check("GainsToDecibels", decibelError, 2e-7);
+
+    // Emitters on a spiral around the listener, inside and beyond the max distance.
+    std::vector<float> x(VALUE_COUNT), y(VALUE_COUNT), z(VALUE_COUNT);
+    std::vector<float> minDistances(VALUE_COUNT, 1.0f), maxDistances(VALUE_COUNT, 100.0f), maxDistancesSq(VALUE_COUNT, 10000.0f);
+    for (size_t i = 0; i < VALUE_COUNT; ++i)
+    {
+        float distance = static_cast<float>(i % 150) + 0.5f;
+        x[i] = std::cos(static_cast<float>(i) * 0.7f) * distance;
+        y[i] = 0.0f;
+        z[i] = std::sin(static_cast<float>(i) * 0.7f) * distance;
+    }
+    std::vector<uint8_t> mask(VALUE_COUNT);
+    Simd::ComputeOutOfRangeMask(x.data(), y.data(), z.data(), maxDistancesSq.data(), VALUE_COUNT, Vector3(0.0f), mask.data());
+    double maskErrors = 0.0;
+    for (size_t i = 0; i < VALUE_COUNT; ++i)
+    {
+        bool outOfRange = x[i] * x[i] + y[i] * y[i] + z[i] * z[i] > maxDistancesSq[i];
+        if(mask[i] != (outOfRange ? 1 : 0)) ++maskErrors;
+    }
+    passed &= Check("ComputeOutOfRangeMask", maskErrors, 0.0);
+
+    std::vector<float> left(VALUE_COUNT), right(VALUE_COUNT);
+    Simd::ComputeSpatialGains(x.data(), y.data(), z.data(), minDistances.data(), maxDistances.data(), VALUE_COUNT,
+                              Vector3(0.0f), Vector3(1.0f, 0.0f, 0.0f), left.data(), right.data());
+    double spatialError = 0.0;
+    for (size_t i = 0; i < VALUE_COUNT; ++i)
+    {
+        double distance = std::sqrt(static_cast<double>(x[i]) * x[i] + static_cast<double>(z[i]) * z[i]);
+        double rolloff = distance <= 1.0 ? 1.0 : std::fmax(0.0, 1.0 - (distance - 1.0) / 99.0) / distance;
+        double pan = (x[i] / distance + 1.0) * 0.5;
+        spatialError = std::fmax(spatialError, std::fabs(left[i] - rolloff * std::sin((1.0 - pan) * PI * 0.5)));
+        spatialError = std::fmax(spatialError, std::fabs(right[i] - rolloff * std::sin(pan * PI * 0.5)));
+    }
+    passed &= Check("ComputeSpatialGains", spatialError, 1e-6);
+
+    // The ramps are summed in float, the error grows with the index.
+    std::vector<float> voice(VALUE_COUNT), busLeft(VALUE_COUNT, 0.0f), busRight(VALUE_COUNT, 0.0f);
+    for (size_t i = 0; i < VALUE_COUNT; ++i) voice[i] = std::sin(static_cast<float>(i) * 0.1f);
+    Simd::MixMonoToStereo(voice.data(), VALUE_COUNT, 0.5f, 0.001f, 0.25f, -0.0001f, busLeft.data(), busRight.data());
+    double mixError = 0.0;
+    for (size_t i = 0; i < VALUE_COUNT; ++i)
+    {
+        mixError = std::fmax(mixError, std::fabs(busLeft[i] - voice[i] * (0.5 + static_cast<double>(i) * 0.001)));
+        mixError = std::fmax(mixError, std::fabs(busRight[i] - voice[i] * (0.25 - static_cast<double>(i) * 0.0001)));
+    }
+    passed &= Check("MixMonoToStereo", mixError, 1e-5);
+
+    std::vector<float> interleaved(2 * VALUE_COUNT);
+    Simd::InterleaveStereo(busLeft.data(), busRight.data(), VALUE_COUNT, interleaved.data());
+    double interleaveErrors = 0.0;
+    for (size_t i = 0; i < VALUE_COUNT; ++i)
+    {
+        if(interleaved[2 * i] != busLeft[i] || interleaved[2 * i + 1] != busRight[i]) ++interleaveErrors;
+    }
+    passed &= Check("InterleaveStereo", interleaveErrors, 0.0);
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+// A stale handle must stay stale: one-shots free and reacquire a slot on every play, far more times than there are generations.
+
+#include "SlotMap.hpp"
+#include <cstdio>
+
+using namespace Voxymore::Audio;
+
+#define CAPACITY 4096
+// More reuses than the generations of a slot, so a stack of free slots would wrap the generation of the first slot.
+#define REUSES (SlotHandle::GenerationMask + 2)
+
+static bool Check(const char* name, bool passed)
+{
+    std::printf("%-48s %s\n", name, passed ? "OK" : "FAILED");
+    return passed;
+}
+
+int main()
+{
+    bool passed = true;
+
+    SlotTable table;
+    table.SetCapacity(CAPACITY);
+    TypeId first = table.Allocate();
+    table.Erase(first);
+
+    // One channel at a time, like a single one-shot played over and over.
+    bool firstStale = true;
+    for (uint32_t i = 0; i < REUSES; ++i)
+    {
+        TypeId id = table.Allocate();
+        firstStale &= table.Find(first) == SlotTable::InvalidIndex && id != first;
+        table.Erase(id);
+    }
+    passed &= Check("First handle rejected after the reuses", firstStale && table.Find(first) == SlotTable::InvalidIndex);
+
+    // The slots are given back in the order they were freed.
+    TypeId a = table.Allocate();
+    TypeId b = table.Allocate();
+    table.Erase(a);
+    table.Erase(b);
+    bool fifo = true;
+    for (uint32_t i = 0; i < CAPACITY - 2; ++i)
+    {
+        TypeId id = table.Allocate();
+        fifo &= SlotHandle::Index(id) != SlotHandle::Index(a) && SlotHandle::Index(id) != SlotHandle::Index(b);
+        table.Erase(id);
+    }
+    passed &= Check("Freed slots reused last", fifo);
+
+    // Every slot can still be handed out, then the table is full.
+    bool full = true;
+    for (uint32_t i = 0; i < CAPACITY; ++i) full &= table.Allocate() != NullId;
+    passed &= Check("Capacity handed out, then full", full && table.AcquireHandle() == NullId && table.Size() == CAPACITY);
+
+    return passed ? 0 : 1;
+}